@@ -0,0 +1,165 @@
+#include "AllocationCounter.h"
+
+#include <cstdlib>                    // malloc, free, posix_memalign
+#include <new>                        // std::bad_alloc, std::nothrow_t, std::align_val_t, new handler
+
+#ifdef _WIN32
+#include <malloc.h>                   // _aligned_malloc
+#endif
+
+#ifndef NDEBUG
+
+namespace {
+
+thread_local uint64_t allocations = 0;
+
+#ifdef __cpp_aligned_new
+// Over-aligned blocks need their own allocator; MSVC's must be freed with _aligned_free
+void* AlignedMalloc(size_t size, size_t alignment) {
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* memory = nullptr;
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+void AlignedFree(void* memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+#endif
+
+} // namespace
+
+bool CountingAllocations() {
+    return true;
+}
+
+uint64_t ThreadAllocations() {
+    return allocations;
+}
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* memory = std::malloc(size)) return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    std::free(memory);
+}
+
+#ifdef __cpp_aligned_new
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    ++allocations;
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* memory = AlignedMalloc(size, static_cast<size_t>(alignment))) return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size, alignment);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return operator new(size, alignment, std::nothrow);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    AlignedFree(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+    AlignedFree(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept {
+    AlignedFree(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    AlignedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    AlignedFree(memory);
+}
+
+#endif // __cpp_aligned_new
+
+#else
+
+bool CountingAllocations() {
+    return false;
+}
+
+uint64_t ThreadAllocations() {
+    return 0;
+}
+
+#endif
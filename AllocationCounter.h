@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>                    // uint64_t counts
+
+// Debug builds (no NDEBUG) replace the global operator new and delete, the
+// C++17 over-aligned forms included, with plain malloc/free that count, per
+// thread, how often the C++ heap was used.
+// The main loop reads the count around each frame to check that steady
+// frames don't allocate. Memory C libraries and drivers get from malloc
+// themselves isn't seen. Release builds keep the standard allocator, and
+// ThreadAllocations() stays 0.
+bool CountingAllocations();
+
+// operator new calls made by the calling thread so far
+uint64_t ThreadAllocations();
@@ -0,0 +1,44 @@
+#include "AnimalStore.h"
+
+#include <algorithm>                  // std::find
+
+void AnimalStore::Clear() {
+    x.clear();
+    y.clear();
+    scale.clear();
+    prevScale.clear();
+    flags.clear();
+    uv.clear();
+    soundBuffer.clear();
+    button.clear();
+    id.clear();
+    displayName.clear();
+}
+
+int AnimalStore::Add(const std::string& animalId, const std::string& name, const UVRect& sprite, ALuint sound,
+    float posX, float posY, bool unlocked) {
+    x.push_back(posX);
+    y.push_back(posY);
+    scale.push_back(1.0f);
+    prevScale.push_back(1.0f);
+    flags.push_back(unlocked ? (UNLOCKED | SOUND_UNLOCKED) : 0);
+    uv.push_back(sprite);
+    soundBuffer.push_back(sound);
+    button.push_back(-1);
+    id.push_back(animalId);
+    displayName.push_back(name);
+    return Count() - 1;
+}
+
+int AnimalStore::Find(const std::string& animalId) const {
+    auto it = std::find(id.begin(), id.end(), animalId);
+    return (it != id.end()) ? static_cast<int>(it - id.begin()) : -1;
+}
+
+int AnimalStore::Expected() const {
+    const uint8_t mask = UNLOCKED | SOUND_UNLOCKED | FOUND;
+    for (int i = 0; i < Count(); ++i) {
+        if ((flags[i] & mask) == (UNLOCKED | SOUND_UNLOCKED)) return i;
+    }
+    return -1;
+}
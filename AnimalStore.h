@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>                    // uint8_t state flags
+#include <string>                     // Ids and display names
+#include <vector>                     // One contiguous array per field
+
+#include <AL/al.h>                    // OpenAL buffer ids
+
+#include "UVRect.h"                  // Sprite coordinates, GL-free
+
+// Every animal in the level, stored as parallel arrays indexed by an integer
+// handle instead of one struct per animal in a map keyed by name. The hit
+// test, the pop animation and the draw loop each walk only the fields they
+// read. Handles are the level file's order, which is also the unlock order,
+// so "the next animal" is just handle + 1.
+struct AnimalStore {
+    // Bits in `flags`
+    static const uint8_t UNLOCKED = 1 << 0;        // Visible and clickable
+    static const uint8_t SOUND_UNLOCKED = 1 << 1;  // Its sound button can be played
+    static const uint8_t FOUND = 1 << 2;           // Identified by the player
+    static const uint8_t POPPING = 1 << 3;         // Pop tween running on `scale`
+
+    // Hot: read every frame or on every click
+    std::vector<float> x;             // Bottom-left corner, normalized device coordinates
+    std::vector<float> y;
+    std::vector<float> scale;
+    std::vector<float> prevScale;     // `scale` before the last simulation step, for drawing between steps
+    std::vector<uint8_t> flags;
+    std::vector<UVRect> uv;
+
+    // Cold: only touched when an animal is clicked or the level is built
+    std::vector<ALuint> soundBuffer;
+    std::vector<int> button;          // Index into the sound buttons, -1 = none
+    std::vector<std::string> id;
+    std::vector<std::string> displayName;
+
+    void Clear();
+    // Returns the new animal's handle
+    int Add(const std::string& animalId, const std::string& name, const UVRect& sprite, ALuint sound,
+        float posX, float posY, bool unlocked);
+
+    int Count() const { return static_cast<int>(x.size()); }
+    bool Has(int animal, uint8_t flag) const { return (flags[animal] & flag) != 0; }
+
+    // Linear search by id; for loading and tools, not per-frame code. -1 if absent.
+    int Find(const std::string& animalId) const;
+    // The first animal that is unlocked and not found yet, or -1
+    int Expected() const;
+};
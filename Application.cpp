@@ -4,72 +4,163 @@
 #include <algorithm> // Algorithms like std::sort, std::find
 #include <string>                     // std::string class
 #include <cstdint>                    // Fixed-width integer types (e.g., uint8_t)
+#include <cstdlib>                    // std::atoi for command-line values
+#include <memory>                     // std::unique_ptr audio backend, seats
+#include <thread>                     // hardware_concurrency for the seat pool
 
 // OpenGL and related libraries
 #include <glew.h>                     // GLEW for managing OpenGL extensions
 #include <glfw3.h>                    // GLFW for windowing and input
-#include <AL/al.h>                    // OpenAL for audio (main functions)
-#include <AL/alc.h>                   // OpenAL context management
+#include <AL/al.h>                    // ALuint sound buffer handles
 #include <glm/glm.hpp>               // GLM for vector/matrix math
 
-#define STB_IMAGE_IMPLEMENTATION 
 #include "stb_image.h"               // STB image loader
 
 // Standard utilities
 #include <iostream>                  // Standard input/output streams
 #include <map>                       // std::map container
 
-#include <GL/freeglut.h>             // FreeGLUT for rendering text, window handling
-
-const float POP_DURATION = 0.5f;
-const float POP_SCALE = 1.3f;
+#include "AllocationCounter.h"       // Debug check that steady frames don't allocate
+#include "AssetLoader.h"             // Threaded texture/sound decoding
+#include "AssetPack.h"               // Cooked, memory-mapped assets
+#include "AudioBackend.h"            // OpenAL or the miniaudio mixer
+#include "AudioSystem.h"             // OpenAL sources on their own thread
+#include "FrameArena.h"              // Per-frame scratch memory
+#include "FrameScheduler.h"          // Idle-aware frame pacing
+#include "Game.h"                    // Animals, buttons and the rules
+#include "InputScript.h"             // --record click scripts for the headless replay
+#include "LatencyTracker.h"          // Click-to-sound latency percentiles
+#include "LayerCache.h"              // Background and soundboard drawn once, composited per frame
+#include "Level.h"                   // Data-driven animal layout
+#include "Profiler.h"                // Frame timings overlay and CSV capture
+#include "SpscQueue.h"               // Lock-free input event queue
+#include "SpriteBatch.h"             // Batched VBO quad renderer
+#include "SpriteInstances.h"         // One instanced draw for every animal
+#include "TextRenderer.h"            // Bitmap-font text through the sprite batch
+#include "TextureAtlas.h"            // Shared texture for sprites and icons
+#include "TextureStreamer.h"         // Background mip levels sized to the window
+#include "WarmCache.h"               // Decoded assets and shader binaries kept between launches
+#include "WorkerPool.h"              // Parallel board updates
+
+// A std::string, so the once-a-second change check doesn't build one
+const std::string LEVEL_FILE = "assets/level1.json";
+const float LEVEL_WATCH_INTERVAL = 1.0f;  // Seconds between checks for edited level files
+
+// Soundboard icons, shared by every level
+const char* LOCK_ICON = "assets/lock.png";
+const char* PLAY_ICON = "assets/play.png";
+const char* PAUSE_ICON = "assets/pause.png";
 
 ALuint correctSound = 0;
 ALuint incorrectSound = 0;
 
-ALuint backgroundMusic = 0;
-ALuint musicSource = 0;
-
-bool pendingUnlock = false;
-float unlockTimer = 0.0f;
-std::string animalToUnlock = "";
-
+// Picked with --audio openal|mixer; --audio-period sets the mixer's callback period in ms
+std::unique_ptr<AudioBackend> audioBackend;
+AudioSystem audio;
+
+// One board per seat. --seats N splits the window into a grid of N boards
+// that share every texture, sound buffer and the audio device; only the game
+// state is per seat.
+struct Seat {
+    explicit Seat(AudioSystem& audio) : game(audio) {}
+    Game game;
+    bool changed = false;             // Written by the pool during the update
+    LayerCache board;                 // Background and soundboard, redrawn when a button changes
+    unsigned boardRevision = 0;       // Game::SoundboardRevision() the layer was drawn at
+    InstanceBuffer animalInstances;   // What the GPU has for this seat's animals
+};
+std::vector<std::unique_ptr<Seat>> seats;
+int seatColumns = 1;
+int seatRows = 1;
+std::unique_ptr<WorkerPool> workerPool;  // Only with more than one seat
+
+// --record <file> writes every click handled by the first seat, for the headless replay tool
+InputRecorder inputRecorder;
+double loopStartTime = 0.0;  // Script times are relative to the first frame
+
+// Pushed from the GLFW callbacks, drained once per update by ProcessInput()
+struct InputEvent {
+    enum class Type { Press, Release, Move, Key } type = Type::Move;
+    int button = 0;                   // Mouse button, or GLFW key for Type::Key
+    double x = 0.0;                   // Window coordinates, origin top-left
+    double y = 0.0;
+    double time = 0.0;                // glfwGetTime() when the event arrived
+};
 
-struct Message {
-    std::string text = "";
-    float x = 0.0f;
-    float y = 0.0f;
-    float timer = 0.0f;
-    glm::vec3 color = { 1.0f, 1.0f, 0.0f };
-    float scale = 1.0f;
+SpscQueue<InputEvent, 1024> inputEvents;
+
+FrameScheduler frameScheduler;
+
+// Reset at the top of every frame; holds whatever one frame builds and throws away
+FrameArena frameArena;
+
+// Set by work that allocates by design (level reloads, resizes, starting a
+// capture), so debug builds don't flag that frame for heap allocations
+bool frameMayAllocate = true;         // The first frame builds everything
+bool warnedAllocations = false;
+
+// F3 shows the overlay, F4 starts/stops writing profile.csv and latency.csv
+Profiler profiler;
+LatencyTracker latencyTracker;
+int profInput = -1;
+int profUpdate = -1;
+int profDraw = -1;
+int profOverlay = -1;
+int profSwap = -1;
+int countDrawCalls = -1;
+int countInstanceUploads = -1;
+int countTextureBinds = -1;
+int countLiveVoices = -1;
+int countTextureKB = -1;
+int countHeapAllocs = -1;             // Debug builds only
+std::vector<std::string> latencyLines;  // Refilled in place for the overlay
+
+// Optional; built by AssetCooker. Loose files are used when it's missing.
+AssetPack assetPack;
+// Decoded loose assets and shader binaries from the last launch; --no-warm-cache skips it
+WarmCache warmCache;
+
+// Level assets by path, with the file time they were loaded at, so a reload
+// only loads what's new or was edited since
+struct CachedTexture {
+    int stream = -1;                  // TextureStreamer handle
+    long long fileTime = 0;
+};
+struct CachedSound {
+    ALuint buffer = 0;
+    long long fileTime = 0;
 };
+std::map<std::string, CachedTexture> textureCache;
+std::map<std::string, CachedSound> soundCache;
+std::map<std::string, long long> atlasSprites;  // Sprite paths in the atlas -> file time when packed
 
-Message feedbackMessage;
+long long levelFileTime = 0;  // Level file's time when it was last read
 
-GLuint soundboardTex = 0;
-GLuint playTex = 0;
-GLuint pauseTex = 0;
-GLuint lockTex = 0;
+// The background and soundboard are only kept at the mip level the window shows
+TextureStreamer textureStreamer;
+int soundboardStream = -1;
 GLuint soundboardBgTex = 0;
-GLuint backgroundTex = 0;
+int backgroundStream = -1;
 
-GLuint LoadTexture(const char* filepath) {
-    int width, height, channels;
-    unsigned char* data = stbi_load(filepath, &width, &height, &channels, STBI_rgb_alpha);
-    if (!data) {
-        std::cerr << "Failed to load texture: " << filepath << std::endl;
-        return 0;
-    }
+SpriteBatch spriteBatch;
+TextRenderer textRenderer;
+InstancedSprites instancedSprites;     // Animals, when GL 3.3 is there; the sprite batch otherwise
+bool instancing = false;
 
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+// Soundboard heading; built once, redrawn from cached glyph quads
+TextRun headingLine1;
+TextRun headingLine2;
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    stbi_image_free(data);
-    return texture;
-}
+// Sound button panels are tessellated once and redrawn from this buffer
+StaticMesh buttonPanels;
+bool buttonPanelsDirty = true;
+int cornerSegments = 0;  // 0 = pick from the on-screen corner size
+
+// Animal sprites and the play/pause/lock icons all live in one texture
+TextureAtlas spriteAtlas;
+UVRect playUV;
+UVRect pauseUV;
+UVRect lockUV;
 
 GLFWimage LoadIconImage(const char* filepath) {
     GLFWimage icon = { 0, 0, nullptr };
@@ -80,660 +171,483 @@ GLFWimage LoadIconImage(const char* filepath) {
     return icon;
 }
 
-ALuint LoadSound(const char* filepath) {
-    FILE* file = nullptr;
-    if (fopen_s(&file, filepath, "rb") != 0 || !file) {
-        std::cerr << "Failed to open WAV file: " << filepath << std::endl;
-        return 0;
-    }
-
-    // Read the header
-    char header[44];
-    if (fread(header, 1, 44, file) != 44) {
-        std::cerr << "Invalid WAV header (too small)" << std::endl;
-        fclose(file);
-        return 0;
-    }
+const glm::vec3 BUTTON_COLOR(0.906f, 0.737f, 0.369f);
 
-    // Check RIFF header
-    if (memcmp(header, "RIFF", 4) != 0) {
-        std::cerr << "Not a RIFF file" << std::endl;
-        fclose(file);
-        return 0;
-    }
+// Sound button labels, by button; rebuilt whenever a level is applied
+std::vector<TextRun> buttonLabels;
 
-    // Check WAVE format
-    if (memcmp(header + 8, "WAVEfmt ", 8) != 0) {
-        std::cerr << "Not a WAVE file" << std::endl;
-        fclose(file);
-        return 0;
-    }
+void DrawAnimal(const Game& game, int a) {
+    float x, y, size;
+    game.AnimalDrawRect(a, x, y, size);
+    spriteBatch.Draw(spriteAtlas.Texture(), x, y, size, size, game.Animals().uv[a], { 1.0f, 1.0f, 1.0f, 1.0f });
+}
 
-    // Extract audio format information
-    unsigned short audioFormat = *(unsigned short*)(header + 20);
-    if (audioFormat != 1) {  // 1 = PCM
-        std::cerr << "Only PCM format supported" << std::endl;
-        fclose(file);
-        return 0;
-    }
+// Where every animal is this frame. Only the ones that moved since the
+// last frame reach the GPU.
+void UpdateAnimalInstances(Seat& seat) {
+    const AnimalStore& animals = seat.game.Animals();
+    SpriteInstance* instances = frameArena.Allocate<SpriteInstance>(animals.Count());
+    for (int a = 0; a < animals.Count(); ++a) {
+        SpriteInstance& instance = instances[a];
+        seat.game.AnimalDrawRect(a, instance.x, instance.y, instance.width);
+        instance.height = instance.width;
+        instance.u0 = animals.uv[a].u0;
+        instance.v0 = animals.uv[a].v0;
+        instance.u1 = animals.uv[a].u1;
+        instance.v1 = animals.uv[a].v1;
+    }
+    seat.animalInstances.Set(instances, animals.Count());
+}
 
-    unsigned short channels = *(unsigned short*)(header + 22);
-    unsigned sampleRate = *(unsigned*)(header + 24);
-    unsigned short bitsPerSample = *(unsigned short*)(header + 34);
-    unsigned dataSize = *(unsigned*)(header + 40);
+void DrawBackground(GLuint texture) {
+    spriteBatch.Draw(texture, -1.0f, -1.0f, 2.0f, 2.0f, UVRect(), { 1.0f, 1.0f, 1.0f, 1.0f });
+}
 
-    // Validate format
-    if (channels < 1 || channels > 2) {
-        std::cerr << "Unsupported number of channels: " << channels << std::endl;
-        fclose(file);
-        return 0;
-    }
+// For text that changes; static strings should use a cached TextRun instead
+void DrawText(const char* text, float normX, float normY, glm::vec3 color = { 0.0f, 0.0f, 0.0f }) {
+    textRenderer.DrawString(spriteBatch, text, normX, normY, glm::vec4(color.r, color.g, color.b, 1.0f));
+}
 
-    if (bitsPerSample != 8 && bitsPerSample != 16) {
-        std::cerr << "Unsupported bits per sample: " << bitsPerSample << std::endl;
-        fclose(file);
-        return 0;
-    }
+void DrawSoundboard(GLuint texture) {
+    UVRect flipped;
+    flipped.v0 = 1.0f;
+    flipped.v1 = 0.0f;
+    spriteBatch.Draw(texture, -1.0f, -1.0f, 0.4f, 2.0f, flipped, { 1.0f, 1.0f, 1.0f, 1.0f });
+}
 
-    // Read audio data
-    std::vector<char> audioData(dataSize);
-    if (fread(audioData.data(), 1, dataSize, file) != dataSize) {
-        std::cerr << "Failed to read audio data" << std::endl;
-        fclose(file);
-        return 0;
-    }
-    fclose(file);
+// Tessellates every sound button panel into one static mesh. Only needs to run
+// when the buttons are created or the window size changes.
+void RebuildButtonPanels(GLFWwindow* window) {
+    const float radius = 0.05f;
 
-    // Determine OpenAL format
-    ALenum format;
-    if (channels == 1 && bitsPerSample == 8) format = AL_FORMAT_MONO8;
-    else if (channels == 1 && bitsPerSample == 16) format = AL_FORMAT_MONO16;
-    else if (channels == 2 && bitsPerSample == 8) format = AL_FORMAT_STEREO8;
-    else if (channels == 2 && bitsPerSample == 16) format = AL_FORMAT_STEREO16;
-    else {
-        std::cerr << "Unsupported WAV format" << std::endl;
-        return 0;
+    int segments = cornerSegments;
+    if (segments <= 0) {
+        // Roughly one segment per 3 pixels of corner arc, so small windows (and seats) stay cheap
+        int fbW, fbH;
+        glfwGetFramebufferSize(window, &fbW, &fbH);
+        float radiusPixels = radius * std::min(fbW / seatColumns, fbH / seatRows) / 2.0f;
+        segments = std::max(4, std::min(32, static_cast<int>(radiusPixels * static_cast<float>(M_PI) / 2 / 3)));
     }
 
-    // Create OpenAL buffer
-    ALuint buffer;
-    alGenBuffers(1, &buffer);
-    alBufferData(buffer, format, audioData.data(), dataSize, sampleRate);
-
-    // Check for errors
-    ALenum error = alGetError();
-    if (error != AL_NO_ERROR) {
-        std::cerr << "OpenAL error (" << error << ") loading: " << filepath << std::endl;
-        if (buffer) alDeleteBuffers(1, &buffer);
-        return 0;
+    // Every seat has the same layout; only the icons on top differ
+    std::vector<SpriteVertex> verts;
+    for (const auto& button : seats[0]->game.SoundButtons()) {
+        TessellateRoundedRect(verts, button.x, button.y, button.width, button.height, radius, segments,
+            glm::vec4(BUTTON_COLOR.r, BUTTON_COLOR.g, BUTTON_COLOR.b, 1.0f));
     }
-
-    return buffer;
+    buttonPanels.Upload(verts);
+    buttonPanelsDirty = false;
 }
 
-struct SoundButton {
-    float x, y, width, height;
-    std::string label;
-    bool isPlaying = false;
-    bool unlocked = false;
-    glm::vec3 color;
-    ALuint soundSource = 0;
-    ALuint soundBuffer = 0;
-    float playBtnX, playBtnY;
-    float playBtnSize = 0.08f;
-    float lockX, lockY;
-};
-
-struct Animal {
-    GLuint texture = 0;
-    ALuint soundBuffer = 0;
-    float x = 0.0f;
-    float y = 0.0f;
-    float soundX = 0.0f;
-    float soundY = 0.0f;
-    std::string displayName = "";
-    bool unlocked = false;
-    bool soundUnlocked = false;
-    bool found = false;
-    float scale = 1.0f;
-    bool isPopping = false;
-    float popTimer = 0.0f;
-};
+void DrawSoundboardUI(GLFWwindow* window, const Game& game) {
+    const glm::vec4 white(1.0f, 1.0f, 1.0f, 1.0f);
+    spriteBatch.Draw(textureStreamer.Texture(soundboardStream), -1.0f, -1.0f, 0.5f, 2.0f, UVRect(), white);
 
-std::map<std::string, Animal> animals;
-std::vector<std::string> animalOrder = { "cat", "bird", "lion", "elephant", "dog", "cow" };
-std::vector<SoundButton> soundButtons;
-std::vector<ALuint> tempSources; // For managing temporary sound sources
+    // Panels first, then every icon from the atlas, so each group is one draw call
+    if (buttonPanelsDirty) RebuildButtonPanels(window);
+    spriteBatch.DrawStatic(buttonPanels, 0);
 
-void DrawAnimal(const Animal& a) {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, a.texture);
+    for (const auto& button : game.SoundButtons()) {
+        if (button.unlocked) {
+            spriteBatch.Draw(spriteAtlas.Texture(), button.playBtnX, button.playBtnY, button.playBtnSize, button.playBtnSize,
+                button.isPlaying ? pauseUV : playUV, white);
+        }
+        else {
+            spriteBatch.Draw(spriteAtlas.Texture(), button.lockX, button.lockY, button.playBtnSize, button.playBtnSize,
+                lockUV, white);
+        }
+    }
 
-    glPushMatrix();
-    glTranslatef(a.x + 0.1f, a.y + 0.1f, 0);
-    glScalef(a.scale, a.scale, 1.0f);
-    glTranslatef(-(a.x + 0.1f), -(a.y + 0.1f), 0);
+    // All text shares the glyph texture, so this is one more draw call
+    textRenderer.Draw(spriteBatch, headingLine1);
+    textRenderer.Draw(spriteBatch, headingLine2);
+    const std::vector<SoundButton>& buttons = game.SoundButtons();
+    for (size_t b = 0; b < buttons.size(); ++b) {
+        if (buttons[b].unlocked) {
+            textRenderer.Draw(spriteBatch, buttonLabels[b]);
+        }
+    }
+}
 
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 1); glVertex2f(a.x, a.y);
-    glTexCoord2f(1, 1); glVertex2f(a.x + 0.2f, a.y);
-    glTexCoord2f(1, 0); glVertex2f(a.x + 0.2f, a.y + 0.2f);
-    glTexCoord2f(0, 0); glVertex2f(a.x, a.y + 0.2f);
-    glEnd();
+// Brings the seat's cached background and soundboard up to date, redrawing
+// them only if a button changed or the layer was invalidated. Returns false
+// if layers can't be used here, in which case they're drawn straight to the
+// window. Must be called outside spriteBatch.Begin()/End().
+bool UpdateBoardLayer(GLFWwindow* window, Seat& seat, int width, int height) {
+    if (!seat.board.Resize(width, height)) return false;
+
+    const unsigned revision = seat.game.SoundboardRevision();
+    if (revision != seat.boardRevision) {
+        seat.boardRevision = revision;
+        seat.board.Invalidate();
+    }
+    if (!seat.board.Dirty()) return true;
+
+    seat.board.Begin();
+    spriteBatch.Begin();
+    DrawBackground(textureStreamer.Texture(backgroundStream));
+    DrawSoundboardUI(window, seat.game);
+    spriteBatch.End();
+    seat.board.End();
+    return true;
+}
 
-    glPopMatrix();
+// Textures the layers were drawn with changed
+void InvalidateBoardLayers() {
+    for (auto& seat : seats) {
+        seat->board.Invalidate();
+    }
 }
 
-bool IsClicked(float mouseX, float mouseY, float x, float y) {
-    return mouseX >= x && mouseX <= x + 0.2f && mouseY >= y && mouseY <= y + 0.2f;
+// Assets every level uses; loaded once at startup
+void QueueSharedAssets(AssetLoader& loader) {
+    loader.QueueSound("assets/correct.wav", &correctSound);
+    loader.QueueSound("assets/incorrect.wav", &incorrectSound);
 }
 
-void DrawBackground(GLuint texture) {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture);
+// Queues whatever the level needs that isn't loaded yet or changed on disk.
+// Returns true if the sprite atlas has to be rebuilt once loading finishes.
+bool QueueLevelAssets(const LevelDef& level, AssetLoader& loader) {
+    // Streamed at the size they're drawn at: the background fills the window,
+    // the soundboard a quarter of its width
+    const struct { const std::string* path; float coverageX; } textures[] = {
+        { &level.background, 1.0f }, { &level.soundboard, 0.25f },
+    };
+    for (const auto& texture : textures) {
+        CachedTexture& cached = textureCache[*texture.path];
+        const long long fileTime = FileModifiedTime(*texture.path);
+        if (cached.stream >= 0 && cached.fileTime == fileTime) continue;
 
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 1); glVertex2f(-1, -1);
-    glTexCoord2f(1, 1); glVertex2f(1, -1);
-    glTexCoord2f(1, 0); glVertex2f(1, 1);
-    glTexCoord2f(0, 0); glVertex2f(-1, 1);
-    glEnd();
+        cached.fileTime = fileTime;
+        if (cached.stream >= 0) textureStreamer.Reload(cached.stream);
+        else cached.stream = textureStreamer.Add(*texture.path, texture.coverageX, 1.0f);
+    }
 
-    glDisable(GL_TEXTURE_2D);
-}
+    for (const auto& def : level.animals) {
+        CachedSound& cached = soundCache[def.sound];
+        const long long fileTime = FileModifiedTime(def.sound);
+        if (cached.buffer && cached.fileTime == fileTime) continue;
 
-void UpdateAnimations(float deltaTime) {
-    for (auto& pair : animals) {
-        Animal& animal = pair.second;
-        if (animal.isPopping) {
-            animal.popTimer += deltaTime;
-            float progress = animal.popTimer / POP_DURATION;
+        DeleteSound(cached.buffer);
+        cached.fileTime = fileTime;
+        loader.QueueSound(def.sound, &cached.buffer);
+    }
 
-            if (progress < 0.5f) {
-                animal.scale = 1.0f + (POP_SCALE - 1.0f) * (progress * 2);
-            }
-            else {
-                animal.scale = POP_SCALE - (POP_SCALE - 1.0f) * ((progress - 0.5f) * 2);
-            }
+    // The atlas can't be patched in place, so any new or edited sprite repacks all of them
+    std::map<std::string, long long> sprites;
+    for (const char* icon : { LOCK_ICON, PLAY_ICON, PAUSE_ICON }) {
+        sprites[icon] = FileModifiedTime(icon);
+    }
+    for (const auto& def : level.animals) {
+        sprites[def.sprite] = FileModifiedTime(def.sprite);
+    }
+    if (sprites == atlasSprites) return false;
 
-            if (animal.popTimer >= POP_DURATION) {
-                animal.isPopping = false;
-                animal.scale = 1.0f;
-            }
-        }
+    atlasSprites = sprites;
+    for (const auto& pair : sprites) {
+        loader.QueueSprite(pair.first, &spriteAtlas, pair.first);
     }
+    return true;
 }
 
-void UpdateMessages(float deltaTime) {
-    if (feedbackMessage.timer > 0.0f) {
-        feedbackMessage.timer -= deltaTime;
-        if (feedbackMessage.timer <= 0.0f) {
-            feedbackMessage.text = "";
+// Frees cached assets the current level no longer references
+void PruneLevelAssets(const LevelDef& level) {
+    for (auto it = textureCache.begin(); it != textureCache.end();) {
+        if (it->first != level.background && it->first != level.soundboard) {
+            textureStreamer.Remove(it->second.stream);
+            it = textureCache.erase(it);
+        }
+        else {
+            ++it;
         }
     }
-}
-
-void CleanUpTempSources() {
-    // Clean up finished temporary sources
-    tempSources.erase(std::remove_if(tempSources.begin(), tempSources.end(),
-        [](ALuint source) {
-            ALint state;
-            alGetSourcei(source, AL_SOURCE_STATE, &state);
-            if (state != AL_PLAYING) {
-                alDeleteSources(1, &source);
-                return true;
-            }
-            return false;
-        }), tempSources.end());
-
-    // Update sound button states (if any sound finishes)
-    for (auto& button : soundButtons) {
-        if (button.isPlaying) {
-            ALint state;
-            alGetSourcei(button.soundSource, AL_SOURCE_STATE, &state);
-            if (state != AL_PLAYING) {
-                button.isPlaying = false; // Reset to play.png
+    for (auto it = soundCache.begin(); it != soundCache.end();) {
+        bool used = false;
+        for (const auto& def : level.animals) {
+            if (def.sound == it->first) {
+                used = true;
+                break;
             }
         }
+        if (!used) {
+            DeleteSound(it->second.buffer);
+            it = soundCache.erase(it);
+        }
+        else {
+            ++it;
+        }
     }
 }
 
-void DrawText(GLFWwindow* window, const std::string& text, float normX, float normY, glm::vec3 color = { 0.0f, 0.0f, 0.0f }) {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-    glDisable(GL_TEXTURE_2D);   // Disable textures so background doesn't affect text
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_BLEND);        // Avoid blending hiding solid text
-
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
+// Packs the decoded sprites into the atlas and hands out the icon UV rectangles
+void BuildSpriteAtlas() {
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (!spriteAtlas.Build(maxSize)) return;
 
-    int width, height;
-    glfwGetWindowSize(window, &width, &height);
-    glOrtho(0, width, height, 0, -1, 1);
-
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+    playUV = spriteAtlas.Lookup(PLAY_ICON);
+    pauseUV = spriteAtlas.Lookup(PAUSE_ICON);
+    lockUV = spriteAtlas.Lookup(LOCK_ICON);
+}
 
-    glColor3f(color.r, color.g, color.b);
+// Builds the animals and buttons from a level whose assets have finished loading.
+// Progress starts over, so a reloaded layout is seen the way a player would.
+void ApplyLevel(const LevelDef& level, bool atlasChanged) {
+    if (atlasChanged) BuildSpriteAtlas();
 
-    int x = (int)((normX + 1.0f) * width / 2.0f);
-    int y = (int)((1.0f - normY) * height / 2.0f);
-    glRasterPos2i(x, y);
+    backgroundStream = textureCache[level.background].stream;
+    soundboardStream = textureCache[level.soundboard].stream;
 
-    for (char c : text) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+    std::vector<UVRect> sprites;
+    std::vector<ALuint> sounds;
+    for (const auto& def : level.animals) {
+        sprites.push_back(spriteAtlas.Lookup(def.sprite));
+        sounds.push_back(soundCache[def.sound].buffer);
+    }
+    for (auto& seat : seats) {
+        seat->game.Start(level, sprites, sounds);
     }
 
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
-    glPopAttrib();
+    const std::vector<SoundButton>& buttons = seats[0]->game.SoundButtons();
+    buttonLabels.assign(buttons.size(), TextRun());
+    for (size_t b = 0; b < buttons.size(); ++b) {
+        float textX = buttons[b].x + 0.03f;
+        float textY = buttons[b].y + buttons[b].height / 2.0f - 0.02f;
+        textRenderer.SetRun(buttonLabels[b], buttons[b].label, textX, textY, { 0.0f, 0.0f, 0.0f, 1.0f });
+    }
+    buttonPanelsDirty = true;
 }
 
-void DrawSoundboard(GLuint texture) {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, texture);
-
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 0); glVertex2f(-1.0f, -1.0f);
-    glTexCoord2f(1, 0); glVertex2f(-0.6f, -1.0f);
-    glTexCoord2f(1, 1); glVertex2f(-0.6f, 1.0f);
-    glTexCoord2f(0, 1); glVertex2f(-1.0f, 1.0f);
-    glEnd();
-
-    glDisable(GL_TEXTURE_2D);
-}
+void DrawLoadingScreen(float progress) {
+    const float left = -0.5f, right = 0.5f, bottom = -0.05f, top = 0.05f;
 
-void DrawRoundedRect(float x, float y, float width, float height, float radius) {
-    const int segments = 10;
-
-    glBegin(GL_QUADS);
-    glVertex2f(x + radius, y);
-    glVertex2f(x + width - radius, y);
-    glVertex2f(x + width - radius, y + height);
-    glVertex2f(x + radius, y + height);
-    glEnd();
-
-    glBegin(GL_QUADS);
-    glVertex2f(x, y + radius);
-    glVertex2f(x + radius, y + radius);
-    glVertex2f(x + radius, y + height - radius);
-    glVertex2f(x, y + height - radius);
-
-    glVertex2f(x + width - radius, y + radius);
-    glVertex2f(x + width, y + radius);
-    glVertex2f(x + width, y + height - radius);
-    glVertex2f(x + width - radius, y + height - radius);
-    glEnd();
-
-    glBegin(GL_QUADS);
-    glVertex2f(x + radius, y + height - radius);
-    glVertex2f(x + width - radius, y + height - radius);
-    glVertex2f(x + width - radius, y + height);
-    glVertex2f(x + radius, y + height);
-
-    glVertex2f(x + radius, y);
-    glVertex2f(x + width - radius, y);
-    glVertex2f(x + width - radius, y + radius);
-    glVertex2f(x + radius, y + radius);
-    glEnd();
-
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x + radius, y + radius);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = M_PI + i * (M_PI / 2) / segments;
-        glVertex2f(x + radius + cos(angle) * radius, y + radius + sin(angle) * radius);
-    }
-    glEnd();
-
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x + width - radius, y + radius);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = 1.5f * M_PI + i * (M_PI / 2) / segments;
-        glVertex2f(x + width - radius + cos(angle) * radius, y + radius + sin(angle) * radius);
-    }
-    glEnd();
-
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x + width - radius, y + height - radius);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = 0 + i * (M_PI / 2) / segments;
-        glVertex2f(x + width - radius + cos(angle) * radius, y + height - radius + sin(angle) * radius);
-    }
-    glEnd();
-
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(x + radius, y + height - radius);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = 0.5f * M_PI + i * (M_PI / 2) / segments;
-        glVertex2f(x + radius + cos(angle) * radius, y + height - radius + sin(angle) * radius);
-    }
-    glEnd();
+    spriteBatch.Begin();
+    spriteBatch.DrawRect(left, bottom, right - left, top - bottom, { 0.25f, 0.25f, 0.25f, 1.0f });  // Empty track
+    spriteBatch.DrawRect(left, bottom, (right - left) * progress, top - bottom, { 0.906f, 0.737f, 0.369f, 1.0f });
+    DrawText("LOADING...", -0.08f, 0.12f, { 1.0f, 1.0f, 1.0f });
+    spriteBatch.End();
 }
 
-void DrawSoundboardUI(GLFWwindow* window) {
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glColor3f(1.0f, 1.0f, 1.0f);
-
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, soundboardTex);
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 1); glVertex2f(-1.0f, -1.0f);
-    glTexCoord2f(1, 1); glVertex2f(-0.5f, -1.0f);
-    glTexCoord2f(1, 0); glVertex2f(-0.5f, 1.0f);
-    glTexCoord2f(0, 0); glVertex2f(-1.0f, 1.0f);
-    glEnd();
-    glDisable(GL_TEXTURE_2D);
-
-    glColor3f(1.0f, 1.0f, 0.0f);
-    DrawText(window, "FIND THE", -0.82f, 0.85f);
-    DrawText(window, "HIDDEN ANIMALS", -0.87f, 0.78f);
-
-    for (const auto& button : soundButtons) {
-        glColor3f(button.color.r, button.color.g, button.color.b);
-        DrawRoundedRect(button.x, button.y, button.width, button.height, 0.05f);
+// Keeps the window responsive with a progress bar while uploads trickle in.
+// Also waits for the streamed textures' first level, so the level never
+// shows up without its background.
+void RunLoader(GLFWwindow* window, AssetLoader& loader) {
+    while ((!loader.Done() || !textureStreamer.Idle()) && !glfwWindowShouldClose(window)) {
+        loader.UploadReady(0.008);  // Spend at most ~half a 60 Hz frame uploading
+        textureStreamer.Update(0.004);
 
-        if (button.unlocked) {
-            float textX = button.x + 0.03f;
-            float textY = button.y + button.height / 2.0f - 0.02f;
-
-            glDisable(GL_TEXTURE_2D);
-            glColor3f(0.0f, 0.0f, 0.0f);
-            DrawText(window, button.label, textX, textY);
-            glEnable(GL_TEXTURE_2D);
-        }
+        glClear(GL_COLOR_BUFFER_BIT);
+        glLoadIdentity();
+        DrawLoadingScreen(loader.Progress());
 
-        if (button.unlocked) {
-            glEnable(GL_TEXTURE_2D);
-            glColor3f(1.0f, 1.0f, 1.0f);
-            glBindTexture(GL_TEXTURE_2D, button.isPlaying ? pauseTex : playTex);
-            glBegin(GL_QUADS);
-            glTexCoord2f(0, 1); glVertex2f(button.playBtnX, button.playBtnY);
-            glTexCoord2f(1, 1); glVertex2f(button.playBtnX + button.playBtnSize, button.playBtnY);
-            glTexCoord2f(1, 0); glVertex2f(button.playBtnX + button.playBtnSize, button.playBtnY + button.playBtnSize);
-            glTexCoord2f(0, 0); glVertex2f(button.playBtnX, button.playBtnY + button.playBtnSize);
-            glEnd();
-            glDisable(GL_TEXTURE_2D);
-        }
-        else {
-            glEnable(GL_TEXTURE_2D);
-            glColor3f(1.0f, 1.0f, 1.0f);
-            glBindTexture(GL_TEXTURE_2D, lockTex);
-            glBegin(GL_QUADS);
-            glTexCoord2f(0, 1); glVertex2f(button.lockX, button.lockY);
-            glTexCoord2f(1, 1); glVertex2f(button.lockX + button.playBtnSize, button.lockY);
-            glTexCoord2f(1, 0); glVertex2f(button.lockX + button.playBtnSize, button.lockY + button.playBtnSize);
-            glTexCoord2f(0, 0); glVertex2f(button.lockX, button.lockY + button.playBtnSize);
-            glEnd();
-            glDisable(GL_TEXTURE_2D);
-        }
+        glfwSwapBuffers(window);
+        glfwPollEvents();
     }
 }
 
-void InitializeAnimals() {
-    soundboardTex = LoadTexture("assets/soundboard.jpg");
-    backgroundTex = LoadTexture("assets/backg.jpg");
-    lockTex = LoadTexture("assets/lock.png");
-    playTex = LoadTexture("assets/play.png");
-    pauseTex = LoadTexture("assets/pause.png");
-
-    correctSound = LoadSound("assets/correct.wav");
-    incorrectSound = LoadSound("assets/incorrect.wav");
-
-    const glm::vec3 goldenColor(0.906f, 0.737f, 0.369f);
-
-    // Initialize animals with their sound buffers
-    animals["cat"] = {
-        LoadTexture("assets/cat.png"),
-        LoadSound("assets/cat.wav"),
-        0.0f, -0.4f,
-        -0.95f, 0.85f,
-        "CAT",
-        true,
-        true
-    };
-
-    animals["lion"] = {
-        LoadTexture("assets/lion.png"),
-        LoadSound("assets/lion.wav"),
-        0.9f, -0.8f,
-        -0.95f, 0.60f,
-        "LION",
-        false,
-        false
-    };
-
-    animals["elephant"] = {
-        LoadTexture("assets/elephant.png"),
-        LoadSound("assets/elephant.wav"),
-        -0.5f, 0.35f,
-        -0.95f, 0.35f,
-        "ELEPHANT",
-        false,
-        false
-    };
+// Re-reads the level file and swaps it in without touching the GL/AL
+// contexts. Only new or edited assets are loaded. A broken file keeps the
+// current level, so a half-saved edit doesn't take the game down.
+void ReloadLevel(GLFWwindow* window) {
+    frameMayAllocate = true;
+    levelFileTime = FileModifiedTime(LEVEL_FILE);
 
-    animals["bird"] = {
-        LoadTexture("assets/bird.png"),
-        LoadSound("assets/bird.wav"),
-        0.3f, -0.5f,
-        -0.95f, 0.10f,
-        "BIRD",
-        false,
-        false
-    };
-
-    animals["dog"] = {
-        LoadTexture("assets/dog.png"),
-        LoadSound("assets/dog.wav"),
-        0.75f, 0.6f,
-        -0.95f, -0.15f,
-        "DOG",
-        false,
-        false
-    };
+    LevelDef level;
+    if (!LoadLevel(LEVEL_FILE.c_str(), level)) {
+        std::cerr << "Keeping the current level" << std::endl;
+        return;
+    }
 
-    animals["cow"] = {
-        LoadTexture("assets/cow.png"),
-        LoadSound("assets/cow.wav"),
-        -0.5f, -1.0f,
-        -0.95f, -0.40f,
-        "COW",
-        false,
-        false
-    };
+    // Nothing may still be playing a buffer that's about to be replaced
+    audio.StopAll();
 
-    // Create sound buttons
-    const float containerLeft = -0.97f;
-    const float containerRight = -0.53f;
-    const float containerWidth = containerRight - containerLeft;
-    const float playBtnSize = 0.08f;
-    const int numButtons = animalOrder.size();
-    const float verticalTop = 0.45f;
-    const float verticalBottom = -0.85f;
-    const float verticalGap = 0.04f;
-    const float totalVerticalSpace = verticalTop - verticalBottom;
-    const float buttonHeight = (totalVerticalSpace - (numButtons - 1) * verticalGap) / numButtons;
-    float currentY = verticalTop;
-
-    for (const auto& animalName : animalOrder) {
-        SoundButton sb;
-        sb.x = containerLeft;
-        sb.y = currentY;
-        sb.width = containerWidth;
-        sb.height = buttonHeight;
-        sb.label = animals[animalName].displayName;
-        sb.unlocked = animals[animalName].unlocked;
-        sb.color = goldenColor;
-        sb.soundBuffer = animals[animalName].soundBuffer;
-
-        // Create sound source for this button
-        alGenSources(1, &sb.soundSource);
-        alSourcei(sb.soundSource, AL_BUFFER, sb.soundBuffer);
-        alSourcef(sb.soundSource, AL_GAIN, 1.0f);
-        sb.isPlaying = false;
-
-        sb.playBtnX = sb.x + sb.width - sb.playBtnSize - 0.02f;
-        sb.playBtnY = currentY + (buttonHeight - playBtnSize) / 2;
-        sb.playBtnSize = playBtnSize;
-
-        sb.lockX = sb.x + (sb.width - playBtnSize) / 2;
-        sb.lockY = sb.playBtnY;
-
-        soundButtons.push_back(sb);
-        currentY -= buttonHeight + verticalGap;
-    }
-    // Add this at the end of InitializeAnimals()
-    backgroundMusic = LoadSound("assets/music.wav");  // Replace with your music file
-    if (backgroundMusic) {
-        alGenSources(1, &musicSource);
-        alSourcei(musicSource, AL_BUFFER, backgroundMusic);
-        alSourcei(musicSource, AL_LOOPING, AL_TRUE);  // Make it loop forever
-        alSourcef(musicSource, AL_GAIN, 0.4f); //30% volume
-        alSourcePlay(musicSource);  // Start playing immediately
+    bool atlasChanged;
+    {
+        AssetLoader loader;  // Loose files only; they're what is being edited
+        atlasChanged = QueueLevelAssets(level, loader);
+        RunLoader(window, loader);
     }
+    PruneLevelAssets(level);
+    ApplyLevel(level, atlasChanged);
+    std::cout << "Reloaded " << LEVEL_FILE << std::endl;
 }
 
-void HandleClicks(GLFWwindow* window) {
-    static bool debounce = false;
-
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS && !debounce) {
-        debounce = true;
-
-        double mx, my;
-        glfwGetCursorPos(window, &mx, &my);
-        int winW, winH;
-        glfwGetWindowSize(window, &winW, &winH);
-        float normX = static_cast<float>((mx / winW) * 2 - 1);
-        float normY = static_cast<float>(1 - (my / winH) * 2);
-        //bool clickedSomething = false;
-
-        for (auto& pair : animals) {
-            Animal& animal = pair.second;
-            if (IsClicked(normX, normY, animal.x, animal.y)) {
-                if (animal.unlocked) {
-                    animal.isPopping = true;
-                    animal.popTimer = 0.0f;
-
-                    // ?? Find the expected current animal (first unlocked and not yet identified)
-                    std::string expectedAnimal = "";
-                    for (const std::string& name : animalOrder) {
-                        if (animals[name].unlocked && animals[name].soundUnlocked && !animals[name].found) {
-                            expectedAnimal = name;
-                            break;
-                        }
-                    }
-
-                    if (pair.first == expectedAnimal) {
-                        feedbackMessage.text = "CORRECT!";
-                        feedbackMessage.color = { 1.0f, 1.0f, 0.0f };
-                        animal.found = true;
-                        // Unlock the next animal
-                        auto it = std::find(animalOrder.begin(), animalOrder.end(), pair.first);
-                        if (it != animalOrder.end() && (it + 1) != animalOrder.end()) {
-                            animalToUnlock = *(it + 1);
-                            pendingUnlock = true;
-                            unlockTimer = 2.0f;  // wait 2 seconds
-                            std::string nextAnimal = *(it + 1);
-                            animals[nextAnimal].unlocked = true;
-                            animals[nextAnimal].soundUnlocked = true;
-
-                            // Also unlock sound button
-                            for (auto& button : soundButtons) {
-                                if (button.label == animals[nextAnimal].displayName) {
-                                    button.unlocked = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                    else {
-                        feedbackMessage.text = "WRONG!";
-                        feedbackMessage.color = { 1.0f, 0.0f, 0.0f };
-                    }
+// True if the level file or any asset it uses was saved since it was loaded
+bool LevelFilesChanged() {
+    if (FileModifiedTime(LEVEL_FILE) != levelFileTime) return true;
+    for (const auto& pair : textureCache) {
+        if (FileModifiedTime(pair.first) != pair.second.fileTime) return true;
+    }
+    for (const auto& pair : soundCache) {
+        if (FileModifiedTime(pair.first) != pair.second.fileTime) return true;
+    }
+    for (const auto& pair : atlasSprites) {
+        if (FileModifiedTime(pair.first) != pair.second) return true;
+    }
+    return false;
+}
 
-                    // Show feedback text
-                    // Show "CORRECT" at top center
-                    feedbackMessage.x = 0.0f;   // Center horizontally
-                    feedbackMessage.y = 0.85f;  // Near top
-                    feedbackMessage.timer = 2.0f;
-
-                    // Play the clicked animal sound
-                    ALuint tempSource;
-                    alGenSources(1, &tempSource);
-                    alSourcei(tempSource, AL_BUFFER, animal.soundBuffer);
-                    alSourcePlay(tempSource);
-                    tempSources.push_back(tempSource);
-
-                    // Play feedback sound (correct or incorrect)
-                    ALuint feedbackSource;
-                    alGenSources(1, &feedbackSource);
-                    alSourcei(feedbackSource, AL_BUFFER,
-                        (pair.first == expectedAnimal) ? correctSound : incorrectSound);
-                    alSourcePlay(feedbackSource);
-                    tempSources.push_back(feedbackSource);
+// Drains the clicks queued by the GLFW callbacks since the last update. Every
+// press is handled, even if it was released again before this frame started.
+// Returns true if any click or key changed what's on screen
+bool ProcessInput(GLFWwindow* window) {
+    int winW, winH;
+    glfwGetWindowSize(window, &winW, &winH);
+
+    bool clicked = false;
+    InputEvent event;
+    while (inputEvents.Pop(event)) {
+        if (winW <= 0 || winH <= 0) continue;  // Minimized
+        if (event.type == InputEvent::Type::Press && event.button == GLFW_MOUSE_BUTTON_LEFT) {
+            // The seat under the cursor, and where in it the click landed
+            const double gridX = event.x / winW * seatColumns;
+            const double gridY = event.y / winH * seatRows;
+            const int column = std::min(seatColumns - 1, static_cast<int>(gridX));
+            const int row = std::min(seatRows - 1, static_cast<int>(gridY));
+            const size_t s = static_cast<size_t>(row) * seatColumns + column;
+            if (s >= seats.size()) continue;  // Empty cell at the end of the grid
+
+            float normX = static_cast<float>((gridX - column) * 2 - 1);
+            float normY = static_cast<float>(1 - (gridY - row) * 2);
+            // Any sound the click starts is stamped from when the OS delivered it
+            audio.SetInputTime(LatencyNow() - (glfwGetTime() - event.time));
+            seats[s]->game.HandleClick(normX, normY);
+            audio.SetInputTime(-1.0);
+            if (s == 0) inputRecorder.Click(event.time - loopStartTime, normX, normY);
+            clicked = true;
+        }
+        else if (event.type == InputEvent::Type::Key) {
+            if (event.button == GLFW_KEY_F3) {
+                profiler.ToggleOverlay();
+                clicked = true;
+            }
+            else if (event.button == GLFW_KEY_F4) {
+                frameMayAllocate = true;
+                if (profiler.Capturing()) {
+                    profiler.StopCapture();
+                    latencyTracker.CloseLog();
+                }
+                else if (profiler.StartCapture("profile.csv")) {
+                    latencyTracker.OpenLog("latency.csv");
                 }
-                return;
+            }
+            else if (event.button == GLFW_KEY_F5) {
+                ReloadLevel(window);
+                clicked = true;
             }
         }
+    }
+    return clicked;
+}
 
-        // Check sound button clicks
-        for (auto& button : soundButtons) {
-            if (button.unlocked &&
-                normX >= button.playBtnX && normX <= button.playBtnX + button.playBtnSize &&
-                normY >= button.playBtnY && normY <= button.playBtnY + button.playBtnSize) {
-
-                ALint state;
-                alGetSourcei(button.soundSource, AL_SOURCE_STATE, &state);
+// Tells the scheduler when the next visible change is due. A running tween
+// moves on every frame, so it keeps frames coming at the cap instead.
+void ScheduleTimers() {
+    bool animating = false;
+    for (const auto& seat : seats) {
+        const float next = seat->game.NextTimer();
+        if (next >= 0.0f) frameScheduler.WakeIn(next);
+        animating |= seat->game.Animating();
+    }
+    frameScheduler.SetAnimating(animating);
+    // Button sounds ending need no timer; the audio thread wakes the loop
+}
 
-                if (state == AL_PLAYING) {
-                    alSourceStop(button.soundSource);
-                    button.isPlaying = false;
-                }
-                else {
-                    alSourcePlay(button.soundSource);
-                    button.isPlaying = true;
-                }
+// Every seat shares the audio system, so its events are polled once here and
+// each finished play goes to the seat whose button started it. Latency stamps
+// go to the tracker, whose percentiles the profiler overlay shows.
+// Returns true if any button's play/pause icon changed.
+bool DispatchAudioEvents() {
+    bool changed = false;
+    AudioEvent event;
+    while (audio.PollEvent(event)) {
+        if (event.type == AudioEvent::Type::Started) {
+            latencyTracker.Add(event.latency);
+            latencyTracker.OverlayLines(latencyLines);
+            profiler.SetExtraLines(latencyLines);
+            continue;
+        }
+        for (auto& seat : seats) {
+            if (seat->game.SoundFinished(event.play)) {
+                changed = true;
                 break;
             }
         }
     }
-    else if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_RELEASE) {
-        debounce = false;
-    }
+    return changed;
 }
-void UpdateUnlockTimer(float deltaTime) {
-    if (pendingUnlock) {
-        unlockTimer -= deltaTime;
-        if (unlockTimer <= 0.0f) {
-            animals[animalToUnlock].unlocked = true;
-            animals[animalToUnlock].soundUnlocked = true;
-
-            // Also unlock sound button
-            for (auto& button : soundButtons) {
-                if (button.label == animals[animalToUnlock].displayName) {
-                    button.unlocked = true;
-                    break;
-                }
-            }
 
-            pendingUnlock = false;
-            animalToUnlock = "";
+// Ends the profiler frame. Debug builds also check the frame's heap use on
+// this thread: a steady frame, clicks included, shouldn't allocate at all.
+void FinishFrame(uint64_t allocationsAtStart) {
+    if (CountingAllocations()) {
+        const uint64_t allocations = ThreadAllocations() - allocationsAtStart;
+        profiler.SetCounter(countHeapAllocs, static_cast<int>(allocations));
+        if (allocations > 0 && !frameMayAllocate && !warnedAllocations) {
+            std::cerr << "Warning: a steady frame made " << allocations
+                << " heap allocations (further ones show as heap_allocs in the F3 overlay)" << std::endl;
+            warnedAllocations = true;
         }
     }
+    frameMayAllocate = false;
+    profiler.EndFrame();
 }
 
+// Framebuffer rectangle of one seat, in glViewport's bottom-left origin
+void SeatViewport(size_t s, int fbWidth, int fbHeight, int& x, int& y, int& width, int& height) {
+    const int column = static_cast<int>(s % seatColumns);
+    const int row = static_cast<int>(s / seatColumns);
+    width = fbWidth / seatColumns;
+    height = fbHeight / seatRows;
+    x = column * width;
+    y = (seatRows - 1 - row) * height;
+}
+
+
+int main(int argc, char** argv) {
+    std::string audioBackendName = "openal";
+    AudioBackendConfig audioConfig;
+    int seatCount = 1;
+    bool recording = false;
+    bool useWarmCache = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--audio" && i + 1 < argc) {
+            audioBackendName = argv[++i];
+        }
+        else if (arg == "--audio-period" && i + 1 < argc) {
+            audioConfig.periodMs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (arg == "--seats" && i + 1 < argc) {
+            seatCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--no-warm-cache") {
+            useWarmCache = false;
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            if (!inputRecorder.Open(argv[++i])) return -1;
+            recording = true;
+        }
+        else {
+            std::cerr << "Ignoring unknown argument: " << arg << std::endl;
+        }
+    }
+
+    // Before anything is decoded or compiled; without it everything takes the slow path
+    if (useWarmCache && warmCache.Open(WarmCache::DefaultDirectory())) SetWarmCache(&warmCache);
 
-int main() {
-    int argc = 1;
-    char* argv[1] = { (char*)"Something" };
-    glutInit(&argc, argv);
+    // Seats fill a near-square grid, row by row
+    for (int s = 0; s < seatCount; ++s) {
+        seats.emplace_back(new Seat(audio));
+    }
+    seatColumns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(seatCount))));
+    seatRows = (seatCount + seatColumns - 1) / seatColumns;
+    if (seatCount > 1) {
+        // No more helpers than there are other seats; the main thread takes one too
+        const unsigned cores = std::thread::hardware_concurrency();
+        workerPool.reset(new WorkerPool(std::min(static_cast<unsigned>(seatCount - 1), cores > 1 ? cores - 1 : 1)));
+        if (recording) std::cerr << "--record only records the first seat" << std::endl;
+    }
 
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -760,106 +674,319 @@ endl;
 
     glfwMakeContextCurrent(window);
 
+    glfwSetMouseButtonCallback(window, [](GLFWwindow* w, int button, int action, int) {
+        InputEvent event;
+        event.type = (action == GLFW_PRESS) ? InputEvent::Type::Press : InputEvent::Type::Release;
+        event.button = button;
+        glfwGetCursorPos(w, &event.x, &event.y);
+        event.time = glfwGetTime();
+        inputEvents.Push(event);
+    });
+    glfwSetCursorPosCallback(window, [](GLFWwindow*, double x, double y) {
+        // Leave room for button events if nobody drains the queue for a while
+        if (inputEvents.Size() > 768) return;
+
+        InputEvent event;
+        event.type = InputEvent::Type::Move;
+        event.x = x;
+        event.y = y;
+        event.time = glfwGetTime();
+        inputEvents.Push(event);
+    });
+    glfwSetKeyCallback(window, [](GLFWwindow*, int key, int, int action, int) {
+        if (action != GLFW_PRESS) return;
+
+        InputEvent event;
+        event.type = InputEvent::Type::Key;
+        event.button = key;
+        event.time = glfwGetTime();
+        inputEvents.Push(event);
+    });
+    glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) {
+        frameMayAllocate = true;
+        glViewport(0, 0, width, height);
+        textRenderer.SetViewport(width, height);
+        // Finer levels stream in, coarser ones after a delay. Each seat draws
+        // the textures over its own cell only.
+        textureStreamer.SetFramebufferSize(width / seatColumns, height / seatRows);
+        buttonPanelsDirty = true;  // Corner smoothness follows the pixel size
+        frameScheduler.RequestRedraw();
+    });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow*) {
+        frameScheduler.RequestRedraw();  // Uncovered or restored
+    });
+
     if (glewInit() != GLEW_OK) {
         std::cerr << "Failed to initialize GLEW" << std::endl;
         glfwTerminate();
         return -1;
     }
 
+    glfwSwapInterval(1);  // vsync; the scheduler also caps frames while animating
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Initialize OpenAL
-    ALCdevice* device = alcOpenDevice(NULL);
-    if (!device) {
-        std::cerr << "Failed to open OpenAL device" << std::endl;
+    if (!spriteBatch.Init() || !textRenderer.Init()) {
+        std::cerr << "Failed to initialize sprite renderer" << std::endl;
         glfwTerminate();
         return -1;
     }
 
-    ALCcontext* context = alcCreateContext(device, NULL);
-    if (!alcMakeContextCurrent(context)) {
-        std::cerr << "Failed to make OpenAL context current" << std::endl;
-        alcCloseDevice(device);
+    instancing = instancedSprites.Init();
+
+    profiler.Init();
+    profInput = profiler.AddSection("input", false);
+    profUpdate = profiler.AddSection("update", false);
+    profDraw = profiler.AddSection("draw", true);
+    profOverlay = profiler.AddSection("overlay", true);
+    profSwap = profiler.AddSection("swap", false);
+    countDrawCalls = profiler.AddCounter("draw_calls");
+    countInstanceUploads = profiler.AddCounter("instances_uploaded");
+    countTextureBinds = profiler.AddCounter("texture_binds");
+    countLiveVoices = profiler.AddCounter("live_voices");
+    countTextureKB = profiler.AddCounter("streamed_texture_kb");
+    if (CountingAllocations()) countHeapAllocs = profiler.AddCounter("heap_allocs");
+    // Sized once here, so a click's latency update only overwrites them
+    latencyTracker.OverlayLines(latencyLines);
+    profiler.SetExtraLines(latencyLines);
+
+    int fbWidth, fbHeight;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+    textRenderer.SetViewport(fbWidth, fbHeight);
+    textureStreamer.SetFramebufferSize(fbWidth / seatColumns, fbHeight / seatRows);
+    textureStreamer.SetWakeCallback(glfwPostEmptyEvent);
+    textRenderer.SetRun(headingLine1, "FIND THE", -0.82f, 0.85f, { 0.0f, 0.0f, 0.0f, 1.0f });
+    textRenderer.SetRun(headingLine2, "HIDDEN ANIMALS", -0.87f, 0.78f, { 0.0f, 0.0f, 0.0f, 1.0f });
+
+    // Initialize audio; a mixer that can't open the device falls back to OpenAL
+    audioBackend = CreateAudioBackend(audioBackendName);
+    if (!audioBackend) {
+        std::cerr << "Unknown audio backend: " << audioBackendName << std::endl;
+        audioBackend = CreateAudioBackend("openal");
+    }
+    if (!audioBackend->Init(audioConfig) && audioBackend->Name() != std::string("openal")) {
+        std::cerr << "Falling back to OpenAL" << std::endl;
+        audioBackend = CreateAudioBackend("openal");
+        if (!audioBackend->Init(audioConfig)) audioBackend.reset();
+    }
+    if (!audioBackend || audioBackend->VoiceCount() == 0) {
+        std::cerr << "Failed to initialize audio" << std::endl;
         glfwTerminate();
         return -1;
     }
+    SetSoundBackend(audioBackend.get());
 
-    // Set listener properties
-    alListener3f(AL_POSITION, 0.0f, 0.0f, 0.0f);
-    alListener3f(AL_VELOCITY, 0.0f, 0.0f, 0.0f);
-    ALfloat listenerOri[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f };
-    alListenerfv(AL_ORIENTATION, listenerOri);
+    // Voice calls run on the audio thread from here on; its events wake the idle loop
+    audio.SetWakeCallback(glfwPostEmptyEvent);
+    if (!audio.Start(audioBackend.get(), audioConfig.voices)) {
+        std::cerr << "Failed to create audio voices" << std::endl;
+        audioBackend->Shutdown();
+        glfwTerminate();
+        return -1;
+    }
+
+    LevelDef level;
+    levelFileTime = FileModifiedTime(LEVEL_FILE);
+    if (!LoadLevel(LEVEL_FILE.c_str(), level)) {
+        audio.Shutdown();
+        audioBackend->Shutdown();
+        glfwTerminate();
+        return -1;
+    }
+
+    // Decode on worker threads and keep the window responsive while uploads trickle in
+    bool atlasChanged;
+    {
+        AssetLoader loader;
+        if (assetPack.Open("assets/assets.pak")) {
+            loader.UsePack(&assetPack);
+            textureStreamer.UsePack(&assetPack);
+        }
+        QueueSharedAssets(loader);
+        atlasChanged = QueueLevelAssets(level, loader);
+        RunLoader(window, loader);
+    }
+    for (auto& seat : seats) {
+        seat->game.SetFeedbackSounds(correctSound, incorrectSound);
+    }
+    ApplyLevel(level, atlasChanged);
 
-    InitializeAnimals();
+    // Stream the music from disk instead of holding the whole file in one buffer
+    audioBackend->PlayMusic("assets/music.wav", 0.4f);  // Loops forever at 40% volume
 
+    int instanceUploads = 0;          // Animals sent to the GPU in the last frame drawn
     float lastTime = glfwGetTime();
+    float lastLevelCheck = lastTime;
+    loopStartTime = lastTime;
 
     while (!glfwWindowShouldClose(window)) {
+        frameScheduler.Wait();
+        profiler.BeginFrame();
+        frameArena.Reset();
+        const uint64_t allocationsAtStart = ThreadAllocations();
+
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
 
-        UpdateAnimations(deltaTime);
-        UpdateMessages(deltaTime);
-        CleanUpTempSources();
-        UpdateUnlockTimer(deltaTime);
-
-        glClear(GL_COLOR_BUFFER_BIT);
-        glLoadIdentity();
-
-        DrawBackground(backgroundTex);
-        DrawSoundboardUI(window);
+        // Timers first so a click after a long idle starts its animation from zero
+        bool changed = false;
+        {
+            ProfileScope scope(profiler, profUpdate);
+            changed |= DispatchAudioEvents();
+            // Boards share no mutable state, so they update side by side
+            if (workerPool) {
+                workerPool->ParallelFor(static_cast<int>(seats.size()), [deltaTime](int s) {
+                    seats[s]->changed = seats[s]->game.Advance(deltaTime);
+                });
+            }
+            else {
+                seats[0]->changed = seats[0]->game.Advance(deltaTime);
+            }
+            for (const auto& seat : seats) {
+                changed |= seat->changed;
+            }
+        }
+        {
+            ProfileScope scope(profiler, profInput);
+            changed |= ProcessInput(window);
+        }
+        {
+            // Finished decodes wake the idle wait; coarser levels replace finer
+            // ones on the once-a-second wake below
+            ProfileScope scope(profiler, profUpdate);
+            if (textureStreamer.Update(0.004)) {
+                InvalidateBoardLayers();
+                changed = true;
+            }
+            if (textureStreamer.LoadedLastUpdate()) frameMayAllocate = true;
+        }
 
-        for (const auto& pair : animals) {
-            const Animal& animal = pair.second;
-            DrawAnimal(animal);
+        // Pick up edits to the level file or its assets; the idle wait already wakes once a second
+        if (currentTime - lastLevelCheck >= LEVEL_WATCH_INTERVAL) {
+            lastLevelCheck = currentTime;
+            if (LevelFilesChanged()) {
+                ReloadLevel(window);
+                changed = true;
+            }
         }
 
-        if (feedbackMessage.timer > 0.0f) {
-            DrawText(window, feedbackMessage.text, feedbackMessage.x, feedbackMessage.y, feedbackMessage.color);
+        // Measure steady frames while profiling, not just the ones that changed
+        if (changed || profiler.Enabled()) frameScheduler.RequestRedraw();
+        ScheduleTimers();
+        if (!frameScheduler.ShouldRender()) {
+            FinishFrame(allocationsAtStart);
+            continue;
         }
 
-        HandleClicks(window);
+        {
+            ProfileScope scope(profiler, profDraw);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glLoadIdentity();
+
+            // Each seat is the whole scene squeezed into its cell of the grid
+            glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+            instanceUploads = 0;
+            for (size_t s = 0; s < seats.size(); ++s) {
+                const Game& game = seats[s]->game;
+                int x, y, width, height;
+                SeatViewport(s, fbWidth, fbHeight, x, y, width, height);
+                glViewport(x, y, width, height);
+
+                // Only the animals and the feedback text are drawn fresh each frame
+                const bool layered = UpdateBoardLayer(window, *seats[s], width, height);
+                spriteBatch.Begin();
+                if (layered) {
+                    spriteBatch.Draw(seats[s]->board.Texture(), -1.0f, -1.0f, 2.0f, 2.0f, LayerCache::CompositeUV(),
+                        { 1.0f, 1.0f, 1.0f, 1.0f });
+                }
+                else {
+                    DrawBackground(textureStreamer.Texture(backgroundStream));
+                    DrawSoundboardUI(window, game);
+                }
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+                if (instancing) {
+                    // Flushes the layer first, so the animals still land on top of it
+                    spriteBatch.End();
+                    UpdateAnimalInstances(*seats[s]);
+                    instanceUploads += static_cast<int>(seats[s]->animalInstances.Uploaded());
+                    instancedSprites.Draw(seats[s]->animalInstances, spriteAtlas.Texture());
+                    spriteBatch.Begin();
+                }
+                else {
+                    for (int a = 0; a < game.Animals().Count(); ++a) {
+                        DrawAnimal(game, a);
+                    }
+                }
 
-    // Clean up
-    for (auto& button : soundButtons) {
-        if (button.soundSource) {
-            alDeleteSources(1, &button.soundSource);
+                const Message& feedback = game.Feedback();
+                if (feedback.timer > 0.0f) {
+                    DrawText(feedback.text, feedback.x, feedback.y,
+                        glm::vec3(feedback.color.r, feedback.color.g, feedback.color.b));
+                }
+                spriteBatch.End();
+            }
+            glViewport(0, 0, fbWidth, fbHeight);
         }
-    }
 
-    for (auto& pair : animals) {
-        if (pair.second.soundBuffer) {
-            alDeleteBuffers(1, &pair.second.soundBuffer);
+        if (profiler.Enabled()) {
+            // Scene only; the overlay's own draws are timed separately
+            profiler.SetCounter(countDrawCalls, spriteBatch.DrawCalls() + instancedSprites.DrawCalls());
+            profiler.SetCounter(countInstanceUploads, instanceUploads);
+            profiler.SetCounter(countTextureBinds, spriteBatch.TextureBinds());
+            profiler.SetCounter(countLiveVoices, audio.LiveVoices());
+            profiler.SetCounter(countTextureKB, static_cast<int>(textureStreamer.ResidentBytes() / 1024));
         }
+        if (profiler.OverlayVisible()) {
+            ProfileScope scope(profiler, profOverlay);
+            spriteBatch.Begin();
+            profiler.DrawOverlay(spriteBatch, textRenderer, fbHeight);
+            spriteBatch.End();
+        }
+        spriteBatch.ResetCounters();
+        instancedSprites.ResetCounters();
+
+        {
+            ProfileScope scope(profiler, profSwap);
+            glfwSwapBuffers(window);
+        }
+        frameScheduler.FrameRendered();
+        FinishFrame(allocationsAtStart);
     }
 
-    for (auto source : tempSources) {
-        alDeleteSources(1, &source);
+    // Clean up. Stop the streaming and audio threads and free every voice
+    // before deleting buffers, since a buffer still attached to a source can't go.
+    audioBackend->StopMusic();
+    audio.Shutdown();
+    latencyTracker.CloseLog();
+    if (latencyTracker.Samples() > 0) std::cout << latencyTracker.Summary() << std::endl;
+
+    for (auto& pair : soundCache) {
+        DeleteSound(pair.second.buffer);
     }
 
-    if (correctSound) alDeleteBuffers(1, &correctSound);
-    if (incorrectSound) alDeleteBuffers(1, &incorrectSound);
+    DeleteSound(correctSound);
+    DeleteSound(incorrectSound);
+    ReleaseSoundData();  // No buffer plays from the mapped/decoded samples any more
 
-    // Add this before your other OpenAL cleanup code
-    alSourceStop(musicSource);
-    alDeleteSources(1, &musicSource);
-    alDeleteBuffers(1, &backgroundMusic);
+    audioBackend->Shutdown();
+    audioBackend.reset();
+    assetPack.Close();
 
-    alcMakeContextCurrent(NULL);
-    alcDestroyContext(context);
-    alcCloseDevice(device);
+    profiler.Release();
+    spriteAtlas.Release();
+    buttonPanels.Release();
+    textRenderer.Release();
+    spriteBatch.Release();
+    instancedSprites.Release();
+    textureStreamer.Release();
+    for (auto& seat : seats) {
+        seat->board.Release();
+        seat->animalInstances.Release();
+    }
 
-    glDeleteTextures(1, &playTex);
-    glDeleteTextures(1, &pauseTex);
-    glDeleteTextures(1, &lockTex);
-    glDeleteTextures(1, &soundboardTex);
-    glDeleteTextures(1, &backgroundTex);
+    inputRecorder.Close();
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -0,0 +1,309 @@
+#include "AssetLoader.h"
+#include "AssetPack.h"
+#include "TextureAtlas.h"
+#include "AudioBackend.h"            // Where sound buffers are created
+#include "AudioDecoder.h"            // MP3/FLAC decoding
+#include "MappedFile.h"              // WAV files are mapped, not read
+#include "WarmCache.h"               // Decoded images and sounds from the last launch
+#include "WavFile.h"                 // RIFF chunk walk
+
+#include <chrono>                     // Upload time budget
+#include <iostream>                   // Error reporting
+#include <unordered_map>              // In-place sample owners by buffer
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"               // STB image loader
+
+bool DecodeImage(const char* filepath, ImageData& out) {
+    const WarmCache* cache = GetWarmCache();
+    int channels;
+    if (!cache) {
+        out.pixels = stbi_load(filepath, &out.width, &out.height, &channels, STBI_rgb_alpha);
+    }
+    else {
+        // The file is read once either way: hashed for the cache key, then decoded on a miss
+        MappedFile file;
+        if (file.Open(filepath)) {
+            const uint64_t key = WarmCache::Hash(file.Data(), file.Size());
+            if (cache->LoadDecodedImage(key, out)) return true;
+
+            out.pixels = stbi_load_from_memory(file.Data(), static_cast<int>(file.Size()), &out.width, &out.height,
+                &channels, STBI_rgb_alpha);
+            if (out.pixels) cache->StoreDecodedImage(key, out);
+        }
+    }
+    if (!out.pixels) {
+        std::cerr << "Failed to load texture: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void FreeImage(ImageData& image) {
+    if (image.pixels) {
+        stbi_image_free(image.pixels);
+        image.pixels = nullptr;
+    }
+}
+
+GLuint UploadTexture(const ImageData& image) {
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    return texture;
+}
+
+GLuint LoadTexture(const char* filepath) {
+    ImageData image;
+    if (!DecodeImage(filepath, image)) {
+        return 0;
+    }
+    GLuint texture = UploadTexture(image);
+    FreeImage(image);
+    return texture;
+}
+
+namespace {
+
+AudioBackend* soundBackend = nullptr;
+
+// Samples that in-place buffers read from, by buffer; dropped by DeleteSound()
+std::unordered_map<ALuint, std::shared_ptr<const void>> staticSoundData;
+
+} // namespace
+
+bool ParseWav(const char* filepath, SoundData& out) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(filepath)) {
+        std::cerr << "Failed to open WAV file: " << filepath << std::endl;
+        return false;
+    }
+
+    WavInfo wav;
+    if (!ParseWavChunks(file->Data(), file->Size(), wav, filepath)) {
+        return false;
+    }
+
+    out.format = PcmFormat(wav.channels, wav.bitsPerSample);
+    if (!out.format) {
+        std::cerr << "Unsupported WAV format: " << filepath << std::endl;
+        return false;
+    }
+
+    // Fault the samples in here, on the calling (worker) thread, rather than
+    // inside alBufferData on the main thread
+    volatile unsigned char touch = 0;
+    for (size_t i = 0; i < wav.dataSize; i += 4096) touch = touch + wav.data[i];
+
+    out.sampleRate = wav.sampleRate;
+    out.samples = wav.data;
+    out.size = wav.dataSize;
+    out.owner = std::move(file);
+    return true;
+}
+
+bool DecodeSound(const char* filepath, SoundData& out) {
+    if (!IsCompressedAudio(filepath)) return ParseWav(filepath, out);
+
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        std::cerr << "Failed to open audio file: " << filepath << std::endl;
+        return false;
+    }
+
+    auto decoded = std::make_shared<DecodedAudio>();
+    const WarmCache* cache = GetWarmCache();
+    const uint64_t key = cache ? WarmCache::Hash(file.Data(), file.Size()) : 0;
+    if (!cache || !cache->LoadDecodedSound(key, *decoded)) {
+        if (!DecodeAudio(file.Data(), file.Size(), *decoded, filepath)) {
+            return false;
+        }
+        if (cache) cache->StoreDecodedSound(key, *decoded);
+    }
+
+    out.format = PcmFormat(decoded->channels, 16);
+    out.sampleRate = decoded->sampleRate;
+    out.samples = reinterpret_cast<const unsigned char*>(decoded->samples.data());
+    out.size = decoded->samples.size() * sizeof(int16_t);
+    out.owner = std::move(decoded);
+    return true;
+}
+
+void SetSoundBackend(AudioBackend* backend) {
+    soundBackend = backend;
+}
+
+ALuint UploadPcm(ALenum format, const void* data, size_t size, unsigned sampleRate, const char* name,
+    bool dataOutlivesBuffer) {
+    if (!soundBackend) {
+        std::cerr << "No audio backend for: " << name << std::endl;
+        return 0;
+    }
+    return soundBackend->CreateBuffer(format, data, size, sampleRate, name, dataOutlivesBuffer);
+}
+
+ALuint UploadSound(const SoundData& sound, const char* filepath, bool playInPlace) {
+    ALuint buffer = UploadPcm(sound.format, sound.samples, sound.size, sound.sampleRate, filepath, playInPlace);
+
+    // A static buffer plays from our memory, so it has to stay alive
+    if (buffer && playInPlace && soundBackend->PlaysInPlace()) {
+        staticSoundData[buffer] = sound.owner;
+    }
+    return buffer;
+}
+
+void DeleteSound(ALuint& buffer) {
+    if (buffer && soundBackend) soundBackend->DeleteBuffer(buffer);
+    // The buffer is gone, so nothing reads its samples any more
+    if (buffer) staticSoundData.erase(buffer);
+    buffer = 0;
+}
+
+void ReleaseSoundData() {
+    staticSoundData.clear();
+}
+
+ALuint LoadSound(const char* filepath) {
+    SoundData sound;
+    if (!DecodeSound(filepath, sound)) {
+        return 0;
+    }
+    return UploadSound(sound, filepath);
+}
+
+AssetLoader::AssetLoader(unsigned workerCount) {
+    if (workerCount == 0) {
+        // Leave one core for the main thread, which keeps drawing the loading screen
+        unsigned cores = std::thread::hardware_concurrency();
+        workerCount = cores > 1 ? cores - 1 : 1;
+    }
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&AssetLoader::WorkerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Anything decoded but never uploaded (e.g. window closed mid-load)
+    for (auto& job : finished) {
+        FreeImage(job->image);
+    }
+}
+
+void AssetLoader::QueueTexture(const std::string& filepath, GLuint* target) {
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::Texture;
+    job->filepath = filepath;
+    job->texture = target;
+    if (pack) job->packed = pack->Find(filepath, PackType::Texture);
+    Queue(std::move(job));
+}
+
+void AssetLoader::QueueSound(const std::string& filepath, ALuint* target) {
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::Sound;
+    job->filepath = filepath;
+    job->sound = target;
+    if (pack) job->packed = pack->Find(filepath, PackType::Sound);
+    Queue(std::move(job));
+}
+
+void AssetLoader::QueueSprite(const std::string& filepath, TextureAtlas* atlas, const std::string& name) {
+    auto job = std::make_unique<Job>();
+    job->kind = Job::Kind::Sprite;
+    job->filepath = filepath;
+    job->atlas = atlas;
+    job->spriteName = name;
+    if (pack) job->packed = pack->Find(filepath, PackType::Sprite);
+    Queue(std::move(job));
+}
+
+void AssetLoader::Queue(std::unique_ptr<Job> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(job));
+    }
+    ++total;
+    wake.notify_one();
+}
+
+void AssetLoader::WorkerLoop() {
+    for (;;) {
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) return;
+            job = std::move(pending.front());
+            pending.pop_front();
+        }
+
+        if (job->packed) {
+            // Cooked textures and sounds go to GL/AL straight from the mapping;
+            // sprites still need their own pixels for the atlas
+            job->decoded = job->kind != Job::Kind::Sprite || pack->CopyImage(*job->packed, job->image);
+        }
+        else if (job->kind == Job::Kind::Texture || job->kind == Job::Kind::Sprite) {
+            job->decoded = DecodeImage(job->filepath.c_str(), job->image);
+        }
+        else {
+            job->decoded = DecodeSound(job->filepath.c_str(), job->pcm);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(std::move(job));
+    }
+}
+
+int AssetLoader::UploadReady(double budgetSeconds) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::duration<double>(budgetSeconds);
+
+    int count = 0;
+    do {
+        std::unique_ptr<Job> job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished.empty()) break;
+            job = std::move(finished.front());
+            finished.pop_front();
+        }
+
+        if (job->kind == Job::Kind::Texture && job->packed) {
+            *job->texture = pack->UploadTexture(*job->packed);
+        }
+        else if (job->kind == Job::Kind::Sound && job->packed) {
+            *job->sound = pack->UploadSound(*job->packed);
+        }
+        else if (job->kind == Job::Kind::Texture) {
+            *job->texture = job->decoded ? UploadTexture(job->image) : 0;
+            FreeImage(job->image);
+        }
+        else if (job->kind == Job::Kind::Sprite) {
+            // Packed and uploaded together by TextureAtlas::Build() once everything is in
+            if (job->decoded) job->atlas->Add(job->spriteName, job->image);
+        }
+        else {
+            *job->sound = job->decoded ? UploadSound(job->pcm, job->filepath.c_str()) : 0;
+        }
+        ++uploaded;
+        ++count;
+    } while (Clock::now() < deadline);
+
+    return count;
+}
+
+float AssetLoader::Progress() const {
+    return total ? static_cast<float>(uploaded) / total : 1.0f;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <condition_variable>         // Wakes idle workers when jobs arrive
+#include <deque>                      // Pending and finished job queues
+#include <memory>                     // std::unique_ptr for jobs, shared WAV mappings
+#include <mutex>                      // Guards the job queues
+#include <string>                     // std::string paths
+#include <thread>                     // Decode worker threads
+#include <vector>                     // std::vector buffers
+
+#include <glew.h>                     // GLuint and texture uploads
+#include <AL/al.h>                    // ALuint and buffer uploads
+
+
+class AssetPack;
+class AudioBackend;
+struct PackEntry;
+class TextureAtlas;
+
+// Decoded RGBA pixels, owned by stb_image until freed.
+struct ImageData {
+    int width = 0;
+    int height = 0;
+    unsigned char* pixels = nullptr;
+};
+
+// PCM samples ready to be handed to alBufferData. `samples` points into the
+// mapped WAV file or into PCM decoded from a compressed one; either stays
+// alive as long as something holds `owner`.
+struct SoundData {
+    ALenum format = 0;
+    unsigned sampleRate = 0;
+    std::shared_ptr<const void> owner;
+    const unsigned char* samples = nullptr;
+    size_t size = 0;
+};
+
+// CPU-side decode steps. These touch no GL/AL state and are safe to call from any thread.
+bool DecodeImage(const char* filepath, ImageData& out);
+void FreeImage(ImageData& image);
+bool ParseWav(const char* filepath, SoundData& out);
+// WAV through ParseWav(); MP3/FLAC fully decoded up front
+bool DecodeSound(const char* filepath, SoundData& out);
+
+// GPU/AL-side upload steps. These must run on the thread that owns the contexts.
+GLuint UploadTexture(const ImageData& image);
+// Copies the samples unless `playInPlace`: in place, the buffer keeps the
+// mapping or decoded samples alive until DeleteSound(). Loose files are
+// copied, so saving over one while the game runs (to reload it) is safe.
+ALuint UploadSound(const SoundData& sound, const char* filepath, bool playInPlace = false);
+
+// Sound buffers are created by this backend; set it before the first upload
+void SetSoundBackend(AudioBackend* backend);
+
+// Creates a sound buffer from PCM already in memory, with no copy of our own.
+// When the data is guaranteed to outlive the buffer, the OpenAL backend uses
+// AL_EXT_STATIC_BUFFER where the driver has it, so it plays in place too.
+ALuint UploadPcm(ALenum format, const void* data, size_t size, unsigned sampleRate, const char* name,
+    bool dataOutlivesBuffer);
+// Frees a buffer from UploadSound()/UploadPcm() and zeroes the handle
+void DeleteSound(ALuint& buffer);
+
+// Drops the samples that static buffers still play from. Call only after
+// every sound buffer has been deleted.
+void ReleaseSoundData();
+
+// Synchronous decode + upload, for callers that don't need the async path.
+GLuint LoadTexture(const char* filepath);
+ALuint LoadSound(const char* filepath);
+
+// Decodes queued textures and sounds on worker threads and hands the results
+// back to the main thread, which uploads them one at a time between frames.
+// Each job writes its GL/AL handle into the target the caller supplied, so the
+// target must stay valid until the loader is Done(). Assets found in the
+// cooked pack given to UsePack() skip decoding and upload from the mapping.
+class AssetLoader {
+public:
+    explicit AssetLoader(unsigned workerCount = 0);
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Must be called before queueing; the pack must outlive the loader
+    void UsePack(const AssetPack* assetPack) { pack = assetPack; }
+
+    void QueueTexture(const std::string& filepath, GLuint* target);
+    void QueueSound(const std::string& filepath, ALuint* target);
+    // Decoded pixels go into the atlas under `name` instead of their own texture
+    void QueueSprite(const std::string& filepath, TextureAtlas* atlas, const std::string& name);
+
+    // Uploads finished decodes until none are ready or the time budget runs out.
+    // Returns the number of assets uploaded.
+    int UploadReady(double budgetSeconds);
+
+    float Progress() const;
+    bool Done() const { return uploaded == total; }
+
+private:
+    struct Job {
+        enum class Kind { Texture, Sound, Sprite } kind;
+        std::string filepath;
+        GLuint* texture = nullptr;
+        ALuint* sound = nullptr;
+        TextureAtlas* atlas = nullptr;
+        std::string spriteName;
+        const PackEntry* packed = nullptr;  // Set when the asset comes from the pack
+        bool decoded = false;
+        ImageData image;
+        SoundData pcm;
+    };
+
+    void Queue(std::unique_ptr<Job> job);
+    void WorkerLoop();
+
+    const AssetPack* pack = nullptr;
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::unique_ptr<Job>> pending;
+    std::deque<std::unique_ptr<Job>> finished;
+    bool stopping = false;
+
+    // Only touched from the main thread
+    size_t total = 0;
+    size_t uploaded = 0;
+};
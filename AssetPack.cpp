@@ -0,0 +1,164 @@
+#include "AssetPack.h"
+
+#include <cstdlib>                    // malloc for ImageData pixels
+#include <cstring>                    // memcmp, memcpy, strncmp
+#include <iostream>                   // Error reporting
+#include <vector>                     // Decompression scratch buffer
+
+#include "AudioBackend.h"            // PcmFormat
+#include "BlockCompression.h"        // CPU fallback for BCn
+
+bool AssetPack::Open(const char* filepath) {
+    Close();
+    if (!file.Open(filepath)) return false;
+
+    if (!Validate(filepath)) {
+        Close();
+        return false;
+    }
+
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(file.Data());
+    entries = reinterpret_cast<const PackEntry*>(file.Data() + sizeof(PackHeader));
+    entryCount = header->entryCount;
+    std::cout << "Loaded asset pack " << filepath << " (" << entryCount << " entries)" << std::endl;
+    return true;
+}
+
+void AssetPack::Close() {
+    file.Close();
+    entries = nullptr;
+    entryCount = 0;
+}
+
+// A truncated or stale pack is rejected as a whole; the caller falls back to loose files
+bool AssetPack::Validate(const char* filepath) const {
+    const size_t size = file.Size();
+    if (size < sizeof(PackHeader)) {
+        std::cerr << "Asset pack too small: " << filepath << std::endl;
+        return false;
+    }
+
+    PackHeader header;
+    memcpy(&header, file.Data(), sizeof(header));
+    if (memcmp(header.magic, PACK_MAGIC, 4) != 0 || header.version != PACK_VERSION) {
+        std::cerr << "Asset pack has the wrong format or version, re-run AssetCooker: " << filepath << std::endl;
+        return false;
+    }
+    if (header.entryCount > (size - sizeof(PackHeader)) / sizeof(PackEntry)) {
+        std::cerr << "Asset pack entry table truncated: " << filepath << std::endl;
+        return false;
+    }
+
+    const PackEntry* table = reinterpret_cast<const PackEntry*>(file.Data() + sizeof(PackHeader));
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const PackEntry& entry = table[i];
+        if (entry.offset > size || entry.size > size - entry.offset) {
+            std::cerr << "Asset pack entry out of range: " << filepath << std::endl;
+            return false;
+        }
+        if (entry.type != PackType::Sound) {
+            size_t needed = 0;
+            for (uint32_t level = 0; level < entry.levels; ++level) {
+                needed += PackLevelSize(entry.format, PackLevelDimension(entry.width, level),
+                    PackLevelDimension(entry.height, level));
+            }
+            if (entry.levels == 0 || needed == 0 || needed > entry.size) {
+                std::cerr << "Asset pack texture entry malformed: " << filepath << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+const PackEntry* AssetPack::Find(const std::string& name, PackType type) const {
+    // Only a few dozen entries; a linear scan beats building an index
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        if (entry.type == type && strncmp(entry.name, name.c_str(), PACK_NAME_LENGTH) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+GLuint AssetPack::UploadTexture(const PackEntry& entry, uint32_t firstLevel) const {
+    const bool compressed = entry.format == PackFormat::BC1 || entry.format == PackFormat::BC3;
+    const bool hardwareS3tc = GLEW_EXT_texture_compression_s3tc != 0;
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    if (firstLevel >= entry.levels) firstLevel = entry.levels - 1;
+    const uint32_t levels = entry.levels - firstLevel;
+
+    std::vector<unsigned char> scratch;
+    const unsigned char* level = Data(entry);
+    for (uint32_t skip = 0; skip < firstLevel; ++skip) {
+        level += PackLevelSize(entry.format, PackLevelDimension(entry.width, skip),
+            PackLevelDimension(entry.height, skip));
+    }
+    for (uint32_t i = 0; i < levels; ++i) {
+        const uint32_t w = PackLevelDimension(entry.width, firstLevel + i);
+        const uint32_t h = PackLevelDimension(entry.height, firstLevel + i);
+        const size_t bytes = PackLevelSize(entry.format, w, h);
+
+        if (compressed && hardwareS3tc) {
+            const GLenum internal = (entry.format == PackFormat::BC1)
+                ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, internal, w, h, 0, static_cast<GLsizei>(bytes), level);
+        }
+        else if (compressed) {
+            // No S3TC in the driver: expand on the CPU, still skipping JPEG/PNG decoding
+            scratch.resize(static_cast<size_t>(w) * h * 4);
+            if (entry.format == PackFormat::BC1) DecompressBC1(level, w, h, scratch.data());
+            else DecompressBC3(level, w, h, scratch.data());
+            glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, scratch.data());
+        }
+        else {
+            glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, level);
+        }
+        level += bytes;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+// The pack stays mapped until the AL context is gone, so buffers may play from it in place
+ALuint AssetPack::UploadSound(const PackEntry& entry) const {
+    const ALenum format = PcmFormat(entry.channels, entry.bitsPerSample);
+    if (!format) {
+        std::cerr << "Unsupported sound format in pack: " << entry.name << std::endl;
+        return 0;
+    }
+    return UploadPcm(format, Data(entry), static_cast<size_t>(entry.size), entry.sampleRate, entry.name, true);
+}
+
+bool AssetPack::CopyImage(const PackEntry& entry, ImageData& out) const {
+    const size_t bytes = static_cast<size_t>(entry.width) * entry.height * 4;
+    // stbi_image_free() is plain free(), so FreeImage() can release this too
+    unsigned char* pixels = static_cast<unsigned char*>(malloc(bytes));
+    if (!pixels) return false;
+
+    switch (entry.format) {
+    case PackFormat::RGBA8: memcpy(pixels, Data(entry), bytes); break;
+    case PackFormat::BC1: DecompressBC1(Data(entry), entry.width, entry.height, pixels); break;
+    case PackFormat::BC3: DecompressBC3(Data(entry), entry.width, entry.height, pixels); break;
+    default:
+        free(pixels);
+        return false;
+    }
+
+    out.width = static_cast<int>(entry.width);
+    out.height = static_cast<int>(entry.height);
+    out.pixels = pixels;
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>                     // std::string lookups
+
+#include <glew.h>                     // GLuint texture uploads
+#include <AL/al.h>                    // ALuint sound uploads
+
+#include "AssetLoader.h"             // ImageData
+#include "MappedFile.h"              // Zero-copy access to the pack
+#include "PackFormat.h"              // On-disk layout
+
+// Runtime side of the cooked asset pack (see tools/AssetCooker.cpp). The
+// whole pack is memory-mapped; textures and sounds are handed to GL/AL
+// straight from the mapping, so nothing is decoded at startup. Lookups use
+// the original asset path, so callers don't need to know whether an asset
+// came from the pack or from a loose file.
+class AssetPack {
+public:
+    bool Open(const char* filepath);
+    void Close();
+    bool IsOpen() const { return entries != nullptr; }
+
+    // nullptr if the pack has no entry of that type under `name`
+    const PackEntry* Find(const std::string& name, PackType type) const;
+    const unsigned char* Data(const PackEntry& entry) const { return file.Data() + entry.offset; }
+
+    // Main thread only. Levels above `firstLevel` are skipped, so it becomes
+    // the new texture's level 0.
+    GLuint UploadTexture(const PackEntry& entry, uint32_t firstLevel = 0) const;
+    ALuint UploadSound(const PackEntry& entry) const;
+
+    // Level 0 as RGBA8 in a heap buffer FreeImage() can release. Any thread.
+    bool CopyImage(const PackEntry& entry, ImageData& out) const;
+
+private:
+    bool Validate(const char* filepath) const;
+
+    MappedFile file;
+    const PackEntry* entries = nullptr;
+    uint32_t entryCount = 0;
+};
@@ -0,0 +1,10 @@
+#include "AudioBackend.h"
+
+#include "MixerBackend.h"            // miniaudio device + software mixer
+#include "OpenALBackend.h"           // The platform's OpenAL
+
+std::unique_ptr<AudioBackend> CreateAudioBackend(const std::string& name) {
+    if (name == "openal") return std::unique_ptr<AudioBackend>(new OpenALBackend());
+    if (name == "mixer") return std::unique_ptr<AudioBackend>(new MixerBackend());
+    return nullptr;
+}
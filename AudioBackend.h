@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <memory>                     // std::unique_ptr factory result
+#include <string>                     // Backend names
+
+#include <AL/al.h>                    // ALuint/ALenum, the handle types the game already uses
+
+// Chosen with --audio and --audio-period on the command line
+struct AudioBackendConfig {
+    int voices = 16;                  // Pooled voices for effects; music has its own
+    unsigned periodMs = 10;           // Mixer callback period; lower is snappier but costlier
+    unsigned sampleRate = 0;          // Mixer device rate, 0 = the device's own
+};
+
+// Where sounds end up. The game keeps handing around ALuint buffer handles
+// and PcmFormat() formats whichever backend is active; the OpenAL backend
+// passes them straight through, the mixer backend hands out its own ids.
+// Buffer calls come from the main thread, voice calls from AudioSystem's
+// audio thread only.
+class AudioBackend {
+public:
+    virtual ~AudioBackend() {}
+
+    virtual const char* Name() const = 0;
+    virtual bool Init(const AudioBackendConfig& config) = 0;
+    virtual void Shutdown() = 0;
+
+    // Returns 0 on failure. When the data is guaranteed to outlive the
+    // buffer, the backend may play it in place (see PlaysInPlace()).
+    virtual ALuint CreateBuffer(ALenum format, const void* data, size_t size, unsigned sampleRate,
+        const char* name, bool dataOutlivesBuffer) = 0;
+    // No voice may still be playing the buffer
+    virtual void DeleteBuffer(ALuint buffer) = 0;
+    // True if buffers created with dataOutlivesBuffer keep reading the caller's memory
+    virtual bool PlaysInPlace() const = 0;
+
+    virtual int VoiceCount() const = 0;
+    virtual void StartVoice(int voice, ALuint buffer, float gain) = 0;
+    // Also detaches the buffer
+    virtual void StopVoice(int voice) = 0;
+    virtual void SetVoiceGain(int voice, float gain) = 0;
+    virtual bool VoicePlaying(int voice) const = 0;
+    // When the latest StartVoice() on the voice reaches (or reached) the
+    // speaker, as a LatencyNow() time. False until the backend knows, and
+    // always on backends that can't tell.
+    virtual bool VoiceHeardAt(int, double&) const { return false; }
+
+    // One looping background track, streamed, outside the voice pool
+    virtual bool PlayMusic(const char* filepath, float gain) = 0;
+    virtual void StopMusic() = 0;
+};
+
+// 0 for anything but 8/16-bit mono/stereo
+inline ALenum PcmFormat(unsigned channels, unsigned bitsPerSample) {
+    if (channels == 1 && bitsPerSample == 8) return AL_FORMAT_MONO8;
+    if (channels == 1 && bitsPerSample == 16) return AL_FORMAT_MONO16;
+    if (channels == 2 && bitsPerSample == 8) return AL_FORMAT_STEREO8;
+    if (channels == 2 && bitsPerSample == 16) return AL_FORMAT_STEREO16;
+    return 0;
+}
+
+// "openal" or "mixer"; nullptr for anything else
+std::unique_ptr<AudioBackend> CreateAudioBackend(const std::string& name);
@@ -0,0 +1,112 @@
+#include "AudioDecoder.h"
+
+#include <algorithm>                  // std::transform
+#include <cctype>                     // std::tolower
+#include <iostream>                   // Error reporting
+
+// Decoders here, device I/O for MixerBackend; leave out encoders and generators.
+// MixerBackend.cpp includes the header with the same options.
+#define MA_NO_ENCODING
+#define MA_NO_GENERATION
+#define MINIAUDIO_IMPLEMENTATION
+#include "miniaudio.h"               // MP3/FLAC/WAV decoding
+
+namespace {
+
+// Opens with the file's own channel count unless it has more than two,
+// since OpenAL's core formats stop at stereo
+bool InitDecoder(const unsigned char* bytes, size_t size, ma_decoder& decoder, const char* filepath) {
+    ma_decoder_config config = ma_decoder_config_init(ma_format_s16, 0, 0);
+    if (ma_decoder_init_memory(bytes, size, &config, &decoder) != MA_SUCCESS) {
+        std::cerr << "Failed to decode audio file: " << filepath << std::endl;
+        return false;
+    }
+    if (decoder.outputChannels <= 2) return true;
+
+    ma_decoder_uninit(&decoder);
+    config = ma_decoder_config_init(ma_format_s16, 2, 0);
+    if (ma_decoder_init_memory(bytes, size, &config, &decoder) != MA_SUCCESS) {
+        std::cerr << "Failed to decode audio file: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool IsCompressedAudio(const std::string& filepath) {
+    const size_t dot = filepath.find_last_of('.');
+    if (dot == std::string::npos) return true;
+
+    std::string extension = filepath.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension != "wav";
+}
+
+bool DecodeAudio(const unsigned char* bytes, size_t size, DecodedAudio& out, const char* filepath) {
+    ma_decoder decoder;
+    if (!InitDecoder(bytes, size, decoder, filepath)) return false;
+
+    out.channels = decoder.outputChannels;
+    out.sampleRate = decoder.outputSampleRate;
+
+    // MP3 has no reliable length up front, so size from the estimate when
+    // there is one and keep reading until the decoder runs dry
+    ma_uint64 estimated = 0;
+    ma_decoder_get_length_in_pcm_frames(&decoder, &estimated);
+    out.samples.clear();
+    out.samples.reserve(static_cast<size_t>(estimated) * out.channels);
+
+    const size_t BLOCK_FRAMES = 4096;
+    for (;;) {
+        const size_t used = out.samples.size();
+        out.samples.resize(used + BLOCK_FRAMES * out.channels);
+
+        ma_uint64 framesRead = 0;
+        ma_decoder_read_pcm_frames(&decoder, out.samples.data() + used, BLOCK_FRAMES, &framesRead);
+        out.samples.resize(used + static_cast<size_t>(framesRead) * out.channels);
+        if (framesRead < BLOCK_FRAMES) break;
+    }
+    ma_decoder_uninit(&decoder);
+
+    if (out.samples.empty()) {
+        std::cerr << "No audio decoded from: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+AudioStreamDecoder::AudioStreamDecoder() : decoder(new ma_decoder) {
+}
+
+AudioStreamDecoder::~AudioStreamDecoder() {
+    Close();
+}
+
+bool AudioStreamDecoder::Open(const unsigned char* bytes, size_t size, const char* filepath) {
+    Close();
+    if (!InitDecoder(bytes, size, *decoder, filepath)) return false;
+
+    channels = decoder->outputChannels;
+    sampleRate = decoder->outputSampleRate;
+    open = true;
+    return true;
+}
+
+void AudioStreamDecoder::Close() {
+    if (open) ma_decoder_uninit(decoder.get());
+    open = false;
+}
+
+size_t AudioStreamDecoder::Read(int16_t* out, size_t frames) {
+    if (!open) return 0;
+
+    ma_uint64 framesRead = 0;
+    ma_decoder_read_pcm_frames(decoder.get(), out, frames, &framesRead);
+    return static_cast<size_t>(framesRead);
+}
+
+bool AudioStreamDecoder::Rewind() {
+    return open && ma_decoder_seek_to_pcm_frame(decoder.get(), 0) == MA_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <cstdint>                    // int16_t samples
+#include <memory>                     // Decoder state kept out of the header
+#include <string>                     // std::string paths
+#include <vector>                     // Fully decoded samples
+
+struct ma_decoder;
+
+// True for files that go through miniaudio instead of the zero-copy WAV
+// path (MP3 and FLAC; anything that isn't .wav)
+bool IsCompressedAudio(const std::string& filepath);
+
+// 16-bit PCM decoded from a compressed file, interleaved
+struct DecodedAudio {
+    unsigned channels = 0;
+    unsigned sampleRate = 0;
+    std::vector<int16_t> samples;
+};
+
+// Decodes a whole file that's already in memory. For short effects, which
+// are played many times and should cost nothing to start.
+bool DecodeAudio(const unsigned char* bytes, size_t size, DecodedAudio& out, const char* filepath);
+
+// Decodes a long track a block at a time, for MusicStream. Wraps the
+// bundled miniaudio decoder; mono and stereo files keep their channel
+// count, anything wider is downmixed to stereo.
+class AudioStreamDecoder {
+public:
+    AudioStreamDecoder();
+    ~AudioStreamDecoder();
+
+    AudioStreamDecoder(const AudioStreamDecoder&) = delete;
+    AudioStreamDecoder& operator=(const AudioStreamDecoder&) = delete;
+
+    // `bytes` must stay valid until Close()
+    bool Open(const unsigned char* bytes, size_t size, const char* filepath);
+    void Close();
+    bool IsOpen() const { return open; }
+
+    // Returns the number of frames read; fewer than asked means end of track
+    size_t Read(int16_t* out, size_t frames);
+    bool Rewind();
+
+    unsigned Channels() const { return channels; }
+    unsigned SampleRate() const { return sampleRate; }
+
+private:
+    std::unique_ptr<ma_decoder> decoder;
+    bool open = false;
+    unsigned channels = 0;
+    unsigned sampleRate = 0;
+};
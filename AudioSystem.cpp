@@ -0,0 +1,274 @@
+#include "AudioSystem.h"
+
+#include <chrono>                     // Poll interval
+
+namespace {
+
+// How often the audio thread checks for finished sounds when no command wakes it
+const auto POLL_INTERVAL = std::chrono::milliseconds(10);
+
+// A stamped play the backend hasn't placed by then is reported without a heard time
+const double HEARD_TIMEOUT = 0.5;
+
+} // namespace
+
+AudioSystem::~AudioSystem() {
+    Shutdown();
+}
+
+bool AudioSystem::Start(AudioBackend* backend, int voices, bool threaded) {
+    if (running) return true;
+    if (!pool.Init(backend, voices)) return false;
+    // Every play holds a voice, so neither list grows past the pool on the audio thread
+    active.reserve(pool.Size());
+    stamped.reserve(pool.Size());
+    undelivered.reserve(pool.Size() * 2);  // A Started and a Finished per voice
+    if (!threaded) return true;
+
+    running = true;
+    worker = std::thread(&AudioSystem::Run, this);
+    return true;
+}
+
+void AudioSystem::Shutdown() {
+    if (running) {
+        running = false;
+        WakeWorker();
+        worker.join();
+    }
+    pool.Release();
+    active.clear();
+    stamped.clear();
+    undelivered.clear();
+}
+
+void AudioSystem::Pump() {
+    if (running) return;
+    FlushEvents();
+    ReapFinished();
+    ReportLatency();
+    liveVoices.store(pool.LiveVoices(), std::memory_order_relaxed);
+}
+
+void AudioSystem::Post(const Command& command) {
+    // Without a thread (not started, or shut down) the commands run right here
+    if (!running) {
+        Execute(command);
+        return;
+    }
+    // Only Play() may be dropped; a lost stop would leave a sound playing
+    while (!commands.Push(command)) {
+        WakeWorker();
+        std::this_thread::yield();
+    }
+    WakeWorker();
+}
+
+void AudioSystem::WakeWorker() {
+    // The worker tests its predicate under sleepMutex. Taking it here means a
+    // push can't land between that test and the wait, which would lose this
+    // notify and leave the command waiting out POLL_INTERVAL.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wakeWorker.notify_one();
+}
+
+void AudioSystem::Sync(Command command) {
+    command.fence = ++nextFence;
+    Post(command);
+    while (fenceDone.load(std::memory_order_acquire) < command.fence) {
+        std::this_thread::yield();
+    }
+}
+
+uint32_t AudioSystem::Play(ALuint buffer, VoicePriority priority, float gain) {
+    if (!buffer) return 0;
+
+    Command command;
+    command.type = Command::Type::Play;
+    command.play = ++nextPlay;
+    if (command.play == 0) command.play = ++nextPlay;  // 0 means "no play"
+    command.buffer = buffer;
+    command.priority = priority;
+    command.gain = gain;
+    if (inputTime >= 0.0) {
+        command.input = inputTime;
+        command.posted = LatencyNow();
+    }
+
+    if (!running) {
+        Execute(command);
+    }
+    else if (!commands.Push(command)) {
+        return 0;
+    }
+    WakeWorker();
+    return command.play;
+}
+
+void AudioSystem::Stop(uint32_t play) {
+    if (!play) return;
+
+    Command command;
+    command.type = Command::Type::Stop;
+    command.play = play;
+    Post(command);
+}
+
+void AudioSystem::SetGain(uint32_t play, float gain) {
+    if (!play) return;
+
+    Command command;
+    command.type = Command::Type::SetGain;
+    command.play = play;
+    command.gain = gain;
+    Post(command);
+}
+
+void AudioSystem::StopAll() {
+    Command command;
+    command.type = Command::Type::StopAll;
+    Sync(command);
+}
+
+void AudioSystem::Run() {
+    while (running) {
+        Command command;
+        while (commands.Pop(command)) {
+            Execute(command);
+        }
+        FlushEvents();
+        ReapFinished();
+        ReportLatency();
+        liveVoices.store(pool.LiveVoices(), std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeWorker.wait_for(lock, POLL_INTERVAL, [this] { return commands.Size() > 0 || !running; });
+    }
+
+    // Fences posted while stopping still have to release their callers
+    Command command;
+    while (commands.Pop(command)) {
+        Execute(command);
+    }
+}
+
+void AudioSystem::Execute(const Command& command) {
+    switch (command.type) {
+    case Command::Type::Play: {
+        ActivePlay entry;
+        entry.play = command.play;
+        entry.voice = pool.Play(command.buffer, command.priority, command.gain);
+        if (entry.voice.index < 0) {
+            Finish(command.play);  // Nothing could be stolen
+        }
+        else {
+            active.push_back(entry);
+            if (command.input >= 0.0) {
+                StampedPlay stamp;
+                stamp.voice = entry.voice;
+                stamp.latency.play = command.play;
+                stamp.latency.input = command.input;
+                stamp.latency.posted = command.posted;
+                stamp.latency.issued = LatencyNow();
+                stamped.push_back(stamp);
+            }
+        }
+        break;
+    }
+    case Command::Type::Stop:
+        for (size_t i = 0; i < active.size(); ++i) {
+            if (active[i].play == command.play) {
+                pool.Stop(active[i].voice);
+                Finish(active[i].play);
+                active[i] = active.back();
+                active.pop_back();
+                break;
+            }
+        }
+        break;
+    case Command::Type::SetGain:
+        for (const auto& entry : active) {
+            if (entry.play == command.play) {
+                pool.SetGain(entry.voice, command.gain);
+                break;
+            }
+        }
+        break;
+    case Command::Type::StopAll:
+        pool.StopAll();
+        for (const auto& entry : active) {
+            Finish(entry.play);
+        }
+        active.clear();
+        break;
+    case Command::Type::Fence:
+        break;
+    }
+
+    if (command.fence) fenceDone.store(command.fence, std::memory_order_release);
+}
+
+// Sounds end (or get stolen) on their own; tell the game about each one once
+void AudioSystem::ReapFinished() {
+    for (size_t i = 0; i < active.size();) {
+        if (!pool.IsPlaying(active[i].voice)) {
+            Finish(active[i].play);
+            active[i] = active.back();
+            active.pop_back();
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void AudioSystem::Finish(uint32_t play) {
+    AudioEvent event;
+    event.type = AudioEvent::Type::Finished;
+    event.play = play;
+    Emit(event);
+}
+
+// A full queue must not lose a Finished event, or its button would show
+// the pause icon forever. Undelivered events wait here, in order, and go
+// out before anything newer.
+void AudioSystem::Emit(const AudioEvent& event) {
+    if (undelivered.empty() && events.Push(event)) {
+        if (wake) wake();
+        return;
+    }
+    undelivered.push_back(event);
+}
+
+void AudioSystem::FlushEvents() {
+    size_t sent = 0;
+    while (sent < undelivered.size() && events.Push(undelivered[sent])) ++sent;
+    if (sent == 0) return;
+
+    undelivered.erase(undelivered.begin(), undelivered.begin() + sent);
+    if (wake) wake();
+}
+
+void AudioSystem::ReportLatency() {
+    if (stamped.empty()) return;
+
+    const double now = LatencyNow();
+    for (size_t i = 0; i < stamped.size();) {
+        StampedPlay& stamp = stamped[i];
+        const bool heard = pool.HeardAt(stamp.voice, stamp.latency.heard);
+        if (!heard && now - stamp.latency.issued < HEARD_TIMEOUT) {
+            ++i;
+            continue;
+        }
+        if (!heard) stamp.latency.heard = -1.0;
+
+        AudioEvent event;
+        event.type = AudioEvent::Type::Started;
+        event.play = stamp.latency.play;
+        event.latency = stamp.latency;
+        Emit(event);
+
+        stamped[i] = stamped.back();
+        stamped.pop_back();
+    }
+}
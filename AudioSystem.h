@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>                     // Fence counter and live voice count
+#include <condition_variable>         // Wakes the audio thread when commands arrive
+#include <cstdint>                    // uint32_t play ids
+#include <mutex>                      // Only for the condition variable's sleep
+#include <thread>                     // The audio thread
+#include <vector>                     // Plays being watched for their end
+
+#include <AL/al.h>                    // OpenAL buffers and sources
+
+#include "LatencyTracker.h"          // Stage stamps of a click's sound
+#include "SourcePool.h"              // Voices, owned by the audio thread
+#include "SpscQueue.h"               // Lock-free commands in, events out
+
+// Sent back from the audio thread. Finished also covers sounds that were
+// stopped or had their voice stolen. Started carries the stage stamps of a
+// play that answered an input event (see SetInputTime()), once the backend
+// has said when it was heard or given up on it.
+struct AudioEvent {
+    enum class Type { Finished, Started } type = Type::Finished;
+    uint32_t play = 0;
+    LatencySample latency;            // Started only
+};
+
+// Runs the source pool on its own thread, so no backend voice call (play,
+// stop, state polling) happens on the game thread during a frame. The game
+// thread posts commands through a lock-free queue and gets events back
+// through another; Play() hands out an id straight away and reports its end
+// later. Only a single game thread may call in.
+class AudioSystem {
+public:
+    ~AudioSystem();
+
+    // The backend must already be initialized and outlive Shutdown(). Without
+    // a thread, commands run inline and Pump() reports finished sounds, which
+    // keeps headless runs deterministic.
+    bool Start(AudioBackend* backend, int voices = SourcePool::DEFAULT_SIZE, bool threaded = true);
+    void Shutdown();
+    // Unthreaded only; does what one pass of the audio thread would
+    void Pump();
+
+    // Called from the audio thread whenever an event is queued, e.g.
+    // glfwPostEmptyEvent to wake an idle main loop
+    void SetWakeCallback(void (*callback)()) { wake = callback; }
+
+    // Plays posted from now on answer the input event that arrived at `time`
+    // (a LatencyNow() time) and are reported with Started events; negative
+    // stops stamping again
+    void SetInputTime(double time) { inputTime = time; }
+
+    // Returns the play id, or 0 if the command queue is full
+    uint32_t Play(ALuint buffer, VoicePriority priority, float gain = 1.0f);
+    void Stop(uint32_t play);
+    void SetGain(uint32_t play, float gain);
+
+    // Waits for the audio thread. Every buffer is detached once it returns,
+    // so buffers can be deleted.
+    void StopAll();
+
+    bool PollEvent(AudioEvent& event) { return events.Pop(event); }
+
+    int LiveVoices() const { return liveVoices.load(std::memory_order_relaxed); }
+
+private:
+    struct Command {
+        enum class Type { Play, Stop, SetGain, StopAll, Fence } type = Type::Fence;
+        uint32_t play = 0;
+        ALuint buffer = 0;
+        VoicePriority priority = VoicePriority::Animal;
+        float gain = 1.0f;
+        uint64_t fence = 0;
+        double input = -1.0;          // Play only, see SetInputTime()
+        double posted = -1.0;
+    };
+
+    struct ActivePlay {
+        uint32_t play = 0;
+        VoiceHandle voice;
+    };
+
+    // A stamped play waiting for the backend to say when it was heard
+    struct StampedPlay {
+        VoiceHandle voice;
+        LatencySample latency;
+    };
+
+    void Post(const Command& command);
+    void Sync(Command command);
+    void Run();
+    // Wakes Run() after a push, or after clearing `running`
+    void WakeWorker();
+    void Execute(const Command& command);
+    void ReapFinished();
+    void Finish(uint32_t play);
+    void Emit(const AudioEvent& event);
+    void FlushEvents();               // Retries events the full queue turned away
+    void ReportLatency();
+
+    SourcePool pool;                  // Audio thread only once started
+    std::vector<ActivePlay> active;
+    std::vector<StampedPlay> stamped;
+
+    SpscQueue<Command, 256> commands;
+    SpscQueue<AudioEvent, 1024> events;
+    std::vector<AudioEvent> undelivered;  // Producer side of `events` only
+
+    uint32_t nextPlay = 0;
+    double inputTime = -1.0;
+    uint64_t nextFence = 0;
+    std::atomic<uint64_t> fenceDone{ 0 };
+    std::atomic<int> liveVoices{ 0 };
+
+    void (*wake)() = nullptr;
+
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wakeWorker;
+};
@@ -0,0 +1,280 @@
+#include "BlockCompression.h"
+
+#include <algorithm>                  // std::min, std::max, std::swap
+#include <cmath>                      // std::sqrt
+#include <cstdint>                    // Fixed-width block fields
+#include <cstdlib>                    // std::abs
+
+namespace {
+
+// Gathers one 4x4 block, repeating the last row/column past the image edge
+void FetchBlock(const unsigned char* rgba, int width, int height, int bx, int by, unsigned char block[16][4]) {
+    for (int y = 0; y < 4; ++y) {
+        const int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x) {
+            const int sx = std::min(bx * 4 + x, width - 1);
+            const unsigned char* src = rgba + (static_cast<size_t>(sy) * width + sx) * 4;
+            for (int c = 0; c < 4; ++c) block[y * 4 + x][c] = src[c];
+        }
+    }
+}
+
+uint16_t To565(const float color[3]) {
+    const int r = std::min(31, std::max(0, static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f)));
+    const int g = std::min(63, std::max(0, static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f)));
+    const int b = std::min(31, std::max(0, static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f)));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void From565(uint16_t packed, int color[3]) {
+    const int r = (packed >> 11) & 31;
+    const int g = (packed >> 5) & 63;
+    const int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+// The four colors a block can use, in index order. Only the four-color mode
+// is used (color0 > color1), which is also how BC3 always reads its colors.
+void ColorPalette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+    From565(c0, palette[0]);
+    From565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+}
+
+void EncodeColorBlock(const unsigned char block[16][4], unsigned char out[8]) {
+    // Principal axis of the block's colors, by a few rounds of power iteration
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i) {
+        for (int c = 0; c < 3; ++c) mean[c] += block[i][c] / 16.0f;
+    }
+    float cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };  // rr rg rb gg gb bb
+    for (int i = 0; i < 16; ++i) {
+        const float r = block[i][0] - mean[0];
+        const float g = block[i][1] - mean[1];
+        const float b = block[i][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iter = 0; iter < 4; ++iter) {
+        const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        const float length = std::sqrt(x * x + y * y + z * z);
+        if (length < 1e-6f) break;  // Flat block; any axis will do
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    // Extremes along the axis become the endpoints, pulled in slightly so
+    // the interpolated colors land closer to the pixels in between
+    float minProj = 1e9f, maxProj = -1e9f;
+    for (int i = 0; i < 16; ++i) {
+        const float proj = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] +
+            (block[i][2] - mean[2]) * axis[2];
+        minProj = std::min(minProj, proj);
+        maxProj = std::max(maxProj, proj);
+    }
+    const float inset = (maxProj - minProj) / 16.0f;
+    minProj += inset;
+    maxProj -= inset;
+
+    float high[3], low[3];
+    for (int c = 0; c < 3; ++c) {
+        high[c] = mean[c] + axis[c] * maxProj;
+        low[c] = mean[c] + axis[c] * minProj;
+    }
+
+    uint16_t c0 = To565(high);
+    uint16_t c1 = To565(low);
+    if (c0 < c1) std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int palette[4][3];
+        ColorPalette(c0, c1, palette);
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                const int dr = block[i][0] - palette[p][0];
+                const int dg = block[i][1] - palette[p][1];
+                const int db = block[i][2] - palette[p][2];
+                const int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(c0 & 0xFF);
+    out[1] = static_cast<unsigned char>(c0 >> 8);
+    out[2] = static_cast<unsigned char>(c1 & 0xFF);
+    out[3] = static_cast<unsigned char>(c1 >> 8);
+    for (int i = 0; i < 4; ++i) out[4 + i] = static_cast<unsigned char>(indices >> (i * 8));
+}
+
+void AlphaPalette(int a0, int a1, int palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    for (int i = 1; i < 7; ++i) palette[1 + i] = ((7 - i) * a0 + i * a1) / 7;
+}
+
+void EncodeAlphaBlock(const unsigned char block[16][4], unsigned char out[8]) {
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = std::max(a0, static_cast<int>(block[i][3]));
+        a1 = std::min(a1, static_cast<int>(block[i][3]));
+    }
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        int palette[8];
+        AlphaPalette(a0, a1, palette);
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDist = 256;
+            for (int p = 0; p < 8; ++p) {
+                const int dist = std::abs(block[i][3] - palette[p]);
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(a0);
+    out[1] = static_cast<unsigned char>(a1);
+    for (int i = 0; i < 6; ++i) out[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+}
+
+// BC1 blocks with color0 <= color1 use three colors plus transparent black;
+// BC3 ignores the order and always uses four
+void DecodeColorBlock(const unsigned char* in, bool threeColorMode, unsigned char block[16][4]) {
+    const uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    const uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    const uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+
+    int palette[4][3];
+    ColorPalette(c0, c1, palette);
+    const bool threeColors = threeColorMode && c0 <= c1;
+    if (threeColors) {
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    for (int i = 0; i < 16; ++i) {
+        const int p = (indices >> (i * 2)) & 3;
+        for (int c = 0; c < 3; ++c) block[i][c] = static_cast<unsigned char>(palette[p][c]);
+        block[i][3] = (threeColors && p == 3) ? 0 : 255;
+    }
+}
+
+void DecodeAlphaBlock(const unsigned char* in, unsigned char block[16][4]) {
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) indices |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+
+    // a0 <= a1 selects the six-step mode with explicit 0 and 255; the
+    // encoder never writes it but other tools do
+    int palette[8];
+    if (in[0] > in[1]) {
+        AlphaPalette(in[0], in[1], palette);
+    }
+    else {
+        palette[0] = in[0];
+        palette[1] = in[1];
+        for (int i = 1; i < 5; ++i) palette[1 + i] = ((5 - i) * in[0] + i * in[1]) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    for (int i = 0; i < 16; ++i) {
+        block[i][3] = static_cast<unsigned char>(palette[(indices >> (i * 3)) & 7]);
+    }
+}
+
+void StoreBlock(const unsigned char block[16][4], int width, int height, int bx, int by, unsigned char* rgba) {
+    for (int y = 0; y < 4; ++y) {
+        const int dy = by * 4 + y;
+        if (dy >= height) break;
+        for (int x = 0; x < 4; ++x) {
+            const int dx = bx * 4 + x;
+            if (dx >= width) break;
+            unsigned char* dst = rgba + (static_cast<size_t>(dy) * width + dx) * 4;
+            for (int c = 0; c < 4; ++c) dst[c] = block[y * 4 + x][c];
+        }
+    }
+}
+
+} // namespace
+
+void CompressBC1(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    out.resize(static_cast<size_t>(blocksX) * blocksY * 8);
+
+    unsigned char block[16][4];
+    unsigned char* dst = out.data();
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            FetchBlock(rgba, width, height, bx, by, block);
+            EncodeColorBlock(block, dst);
+            dst += 8;
+        }
+    }
+}
+
+void CompressBC3(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    out.resize(static_cast<size_t>(blocksX) * blocksY * 16);
+
+    unsigned char block[16][4];
+    unsigned char* dst = out.data();
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            FetchBlock(rgba, width, height, bx, by, block);
+            EncodeAlphaBlock(block, dst);
+            EncodeColorBlock(block, dst + 8);
+            dst += 16;
+        }
+    }
+}
+
+void DecompressBC1(const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+
+    unsigned char block[16][4];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            DecodeColorBlock(blocks, true, block);
+            StoreBlock(block, width, height, bx, by, rgba);
+            blocks += 8;
+        }
+    }
+}
+
+void DecompressBC3(const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+
+    unsigned char block[16][4];
+    for (int by = 0; by < blocksY; ++by) {
+        for (int bx = 0; bx < blocksX; ++bx) {
+            DecodeColorBlock(blocks + 8, false, block);
+            DecodeAlphaBlock(blocks, block);
+            StoreBlock(block, width, height, bx, by, rgba);
+            blocks += 16;
+        }
+    }
+}
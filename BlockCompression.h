@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>                     // Compressed output
+
+// BC1 (DXT1) and BC3 (DXT5) block compression for RGBA8 images.
+// Encoding is a single principal-axis fit per 4x4 block: fast enough for the
+// cooker and noticeably better than a bounding-box fit on diagonal gradients.
+// The decoders are the runtime fallback for drivers without S3TC support.
+// Images whose size isn't a multiple of 4 repeat their edge pixels.
+void CompressBC1(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out);
+void CompressBC3(const unsigned char* rgba, int width, int height, std::vector<unsigned char>& out);
+
+// `rgba` receives width * height * 4 bytes
+void DecompressBC1(const unsigned char* blocks, int width, int height, unsigned char* rgba);
+void DecompressBC3(const unsigned char* blocks, int width, int height, unsigned char* rgba);
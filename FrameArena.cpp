@@ -0,0 +1,50 @@
+#include "FrameArena.h"
+
+#include <algorithm>                  // std::max
+#include <cstdint>                    // uintptr_t for alignment
+
+FrameArena::FrameArena(size_t capacity) {
+    blocks.reserve(4);
+    AddBlock(std::max<size_t>(capacity, 1));
+}
+
+void FrameArena::AddBlock(size_t size) {
+    Block block;
+    block.memory.reset(new unsigned char[size]);
+    block.size = size;
+    blocks.push_back(std::move(block));
+}
+
+size_t FrameArena::Capacity() const {
+    size_t total = 0;
+    for (const auto& block : blocks) total += block.size;
+    return total;
+}
+
+void FrameArena::Reset() {
+    if (blocks.size() > 1) {
+        // Last frame needed more than one block; next time it gets one that fits
+        const size_t total = Capacity();
+        blocks.clear();
+        AddBlock(total);
+    }
+    offset = 0;
+    usedBefore = 0;
+}
+
+void* FrameArena::Allocate(size_t bytes, size_t alignment) {
+    Block* block = &blocks.back();
+    uintptr_t base = reinterpret_cast<uintptr_t>(block->memory.get());
+    size_t start = ((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+
+    if (start + bytes > block->size) {
+        usedBefore += offset;
+        AddBlock(std::max(block->size * 2, bytes + alignment));
+        block = &blocks.back();
+        base = reinterpret_cast<uintptr_t>(block->memory.get());
+        start = ((base + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+    }
+
+    offset = start + bytes;
+    return block->memory.get() + start;
+}
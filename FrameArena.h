@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>                    // size_t, max_align_t
+#include <memory>                     // Block storage
+#include <type_traits>                // Only trivially destructible data goes in
+#include <vector>                     // Chained blocks
+
+// Scratch memory for one frame. Allocate() bumps a pointer through a block
+// and Reset(), at the start of the next frame, takes everything back at
+// once; nothing is freed or destructed on its own, so only plain data
+// belongs here. A frame that outgrows the block chains another onto it, and
+// the next Reset() swaps both for one block big enough for the two, so once
+// the frames have settled the arena doesn't touch the heap at all.
+class FrameArena {
+public:
+    static const size_t DEFAULT_CAPACITY = 64 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+
+    void Reset();
+
+    // Valid until the next Reset()
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+    template <typename T>
+    T* Allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    size_t Used() const { return usedBefore + offset; }
+    size_t Capacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t size = 0;
+    };
+
+    void AddBlock(size_t size);
+
+    std::vector<Block> blocks;        // Allocating from the last one
+    size_t offset = 0;                // Into the last block
+    size_t usedBefore = 0;            // Bytes handed out from the earlier blocks
+};
@@ -0,0 +1,41 @@
+#include "FrameScheduler.h"
+
+#include <glfw3.h>                    // glfwWaitEventsTimeout, glfwGetTime
+
+void FrameScheduler::Wait() {
+    double now = glfwGetTime();
+
+    if (ShouldRender()) {
+        // Animating: hold to the frame cap, but keep servicing events meanwhile
+        const double nextFrame = lastFrameTime + frameInterval;
+        if (now >= nextFrame) {
+            glfwPollEvents();
+        }
+        while (now < nextFrame) {
+            glfwWaitEventsTimeout(nextFrame - now);
+            now = glfwGetTime();
+        }
+    }
+    else {
+        // Idle: sleep until input arrives or the nearest timer is due
+        const double timeout = SleepTime(now);
+        if (timeout > 0.0) {
+            glfwWaitEventsTimeout(timeout);
+        }
+        else {
+            glfwPollEvents();
+        }
+    }
+
+    // Callers re-arm their timers on every pass
+    wakeAt = -1.0;
+}
+
+void FrameScheduler::WakeIn(double seconds) {
+    const double at = glfwGetTime() + std::max(0.0, seconds);
+    wakeAt = (wakeAt < 0.0) ? at : std::min(wakeAt, at);
+}
+
+void FrameScheduler::FrameRendered() {
+    FrameRenderedAt(glfwGetTime());
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>                  // std::min, std::max
+
+// Decides when the main loop should wake up and whether the next pass needs
+// to render. When nothing is animating the loop sleeps in
+// glfwWaitEventsTimeout until input arrives or the nearest timer is due,
+// instead of redrawing an unchanged scene as fast as the driver allows.
+// While something is animating, frames are capped at maxFps.
+class FrameScheduler {
+public:
+    explicit FrameScheduler(double maxFps = 60.0, double idleTimeout = 1.0)
+        : frameInterval(maxFps > 0.0 ? 1.0 / maxFps : 0.0), idleTimeout(idleTimeout) {}
+
+    // Blocks until there is input, a requested wake-up, or the next frame slot
+    void Wait();
+
+    // Something visible changed; render on this pass
+    void RequestRedraw() { redraw = true; }
+    // Something is moving (a tween is running): render every pass at the
+    // frame cap until cleared, not only the pass that started it. Callers
+    // set it on every pass.
+    void SetAnimating(bool value) { animating = value; }
+    // Something visible will change this many seconds from now
+    void WakeIn(double seconds);
+
+    bool ShouldRender() const { return redraw || animating; }
+    void FrameRendered();
+
+    // The decision without GLFW, with `now` in glfwGetTime() seconds, so the
+    // headless tool can check it: FrameRendered() at a given time, and how
+    // long Wait() would sleep with no input arriving
+    void FrameRenderedAt(double now) {
+        lastFrameTime = now;
+        redraw = false;
+    }
+    double SleepTime(double now) const {
+        if (ShouldRender()) return std::max(0.0, lastFrameTime + frameInterval - now);
+        double timeout = idleTimeout;
+        if (wakeAt >= 0.0) timeout = std::min(timeout, std::max(0.0, wakeAt - now));
+        return timeout;
+    }
+    double FrameInterval() const { return frameInterval; }
+
+private:
+    double frameInterval;
+    double idleTimeout;
+    double lastFrameTime = 0.0;
+    double wakeAt = -1.0;             // Absolute glfwGetTime(), < 0 = none
+    bool redraw = true;
+    bool animating = false;
+};
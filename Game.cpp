@@ -0,0 +1,385 @@
+#include "Game.h"
+
+#include <algorithm>                  // std::max
+#include <cmath>                      // std::ceil
+#include <cstring>                    // memcpy for the state hash
+
+#include "AudioSystem.h"             // Clicks, feedback and button sounds
+
+namespace {
+
+const int BUTTON_DEPTH = 0;
+const int ANIMAL_DEPTH = 1;
+
+// The feedback message's slide plus one fade per color channel
+const int FEEDBACK_TWEENS = 4;
+
+// FNV-1a
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+}
+
+void HashFloat(uint64_t& hash, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    HashBytes(hash, &bits, sizeof(bits));
+}
+
+} // namespace
+
+void Game::SetFeedbackSounds(ALuint correct, ALuint incorrect) {
+    correctSound = correct;
+    incorrectSound = incorrect;
+}
+
+// Handles follow the file's order, so unlocking walks forward through the store.
+// Progress starts over, so a reloaded layout is seen the way a player would.
+void Game::Start(const LevelDef& level, const std::vector<UVRect>& sprites, const std::vector<ALuint>& sounds) {
+    tweens.Clear();                   // Before the arrays they point into are rebuilt
+    animals.Clear();
+    for (size_t i = 0; i < level.animals.size(); ++i) {
+        const AnimalDef& def = level.animals[i];
+        animals.Add(def.id, def.displayName, i < sprites.size() ? sprites[i] : UVRect(),
+            i < sounds.size() ? sounds[i] : 0, def.x, def.y, def.unlocked);
+    }
+
+    pendingUnlock = false;
+    animalToUnlock = -1;
+    feedbackMessage.text = "";
+    feedbackMessage.timer = 0.0f;
+    accumulator = 0.0f;
+
+    // A pop per animal plus the message's slide and fade, all at once at most
+    tweens.Reserve(animals.Count() + FEEDBACK_TWEENS);
+    finishedTweens.reserve(animals.Count() + FEEDBACK_TWEENS);
+
+    soundButtons.clear();
+    CreateSoundButtons(level.buttons);
+    ++soundboardRevision;
+    BuildHitGrid();
+}
+
+void Game::CreateSoundButtons(const ButtonLayout& layout) {
+    // Create sound buttons
+    const float containerLeft = -0.97f;
+    const float containerRight = -0.53f;
+    const float containerWidth = containerRight - containerLeft;
+    const float playBtnSize = 0.08f;
+    const int numButtons = animals.Count();
+    const float verticalTop = layout.top;
+    const float verticalBottom = layout.bottom;
+    const float verticalGap = layout.gap;
+    const float totalVerticalSpace = verticalTop - verticalBottom;
+    const float buttonHeight = (totalVerticalSpace - (numButtons - 1) * verticalGap) / numButtons;
+    float currentY = verticalTop;
+
+    for (int a = 0; a < numButtons; ++a) {
+        SoundButton sb;
+        sb.x = containerLeft;
+        sb.y = currentY;
+        sb.width = containerWidth;
+        sb.height = buttonHeight;
+        sb.label = animals.displayName[a];
+        sb.unlocked = animals.Has(a, AnimalStore::SOUND_UNLOCKED);
+        sb.soundBuffer = animals.soundBuffer[a];
+        sb.animal = a;
+
+        sb.isPlaying = false;
+
+        sb.playBtnX = sb.x + sb.width - playBtnSize - 0.02f;
+        sb.playBtnY = currentY + (buttonHeight - playBtnSize) / 2;
+        sb.playBtnSize = playBtnSize;
+
+        sb.lockX = sb.x + (sb.width - playBtnSize) / 2;
+        sb.lockY = sb.playBtnY;
+
+        animals.button[a] = static_cast<int>(soundButtons.size());
+        soundButtons.push_back(sb);
+        currentY -= buttonHeight + verticalGap;
+    }
+}
+
+void Game::AnimalRect(int a, float& x, float& y, float& size) const {
+    size = ANIMAL_SIZE * animals.scale[a];
+    x = animals.x[a] + (ANIMAL_SIZE - size) / 2;
+    y = animals.y[a] + (ANIMAL_SIZE - size) / 2;
+}
+
+void Game::AnimalDrawRect(int a, float& x, float& y, float& size) const {
+    const float alpha = accumulator / SIM_STEP;
+    const float scale = animals.prevScale[a] + (animals.scale[a] - animals.prevScale[a]) * alpha;
+    size = ANIMAL_SIZE * scale;
+    x = animals.x[a] + (ANIMAL_SIZE - size) / 2;
+    y = animals.y[a] + (ANIMAL_SIZE - size) / 2;
+}
+
+// The play icon once unlocked, the lock icon before that
+void Game::UpdateButtonHitRect(int b) {
+    const SoundButton& button = soundButtons[b];
+    hitGrid.Update(ButtonHitId(b), button.unlocked ? button.playBtnX : button.lockX,
+        button.unlocked ? button.playBtnY : button.lockY, button.playBtnSize, button.playBtnSize);
+}
+
+void Game::BuildHitGrid() {
+    hitGrid.Clear();
+
+    // Room in every cell a pop or an unlocked button can reach, so clicks never allocate
+    const float popped = ANIMAL_SIZE * POP_SCALE;
+    const float offset = (ANIMAL_SIZE - popped) / 2;
+    for (int a = 0; a < animals.Count(); ++a) {
+        hitGrid.Reserve(animals.x[a] + offset, animals.y[a] + offset, popped, popped);
+    }
+    for (const auto& button : soundButtons) {
+        hitGrid.Reserve(button.lockX, button.lockY, button.playBtnSize, button.playBtnSize);
+        hitGrid.Reserve(button.playBtnX, button.playBtnY, button.playBtnSize, button.playBtnSize);
+    }
+
+    for (int a = 0; a < animals.Count(); ++a) {
+        float x, y, size;
+        AnimalRect(a, x, y, size);
+        hitGrid.Insert(a, x, y, size, size, ANIMAL_DEPTH);
+    }
+    for (int b = 0; b < static_cast<int>(soundButtons.size()); ++b) {
+        hitGrid.Insert(ButtonHitId(b), 0.0f, 0.0f, 0.0f, 0.0f, BUTTON_DEPTH);
+        UpdateButtonHitRect(b);
+    }
+}
+
+bool Game::Advance(float frameTime) {
+    accumulator += frameTime;
+    if (Animating() && accumulator > MAX_CATCH_UP) accumulator = MAX_CATCH_UP;
+
+    bool changed = false;
+    while (accumulator >= SIM_STEP) {
+        changed |= Update(SIM_STEP);
+        accumulator -= SIM_STEP;
+    }
+    // Tweens are drawn between steps. The main loop keeps rendering at the
+    // frame cap while Animating() (FrameScheduler::SetAnimating), so they
+    // move on every frame and the catch-up clamp only absorbs real hitches.
+    return changed || Animating();
+}
+
+bool Game::Update(float deltaTime) {
+    bool changed = false;
+    changed |= UpdateAnimations(deltaTime);
+    changed |= UpdateMessages(deltaTime);
+    changed |= UpdateUnlockTimer(deltaTime);
+    return changed;
+}
+
+void Game::UpdateAnimalHitRect(int a) {
+    float x, y, size;
+    AnimalRect(a, x, y, size);
+    hitGrid.Update(a, x, y, size, size);
+}
+
+// Returns true while anything is still animating
+bool Game::UpdateAnimations(float deltaTime) {
+    // Only what is moving; the rest of the level isn't touched
+    if (tweens.Empty()) return false;
+
+    finishedTweens.clear();
+    tweens.Update(deltaTime, finishedTweens);
+
+    for (const auto& tween : tweens.Active()) {
+        if (tween.tag >= 0) UpdateAnimalHitRect(tween.tag);
+    }
+    for (int a : finishedTweens) {
+        if (a < 0) continue;
+        if (!tweens.Running(&animals.scale[a])) animals.flags[a] &= ~AnimalStore::POPPING;
+        UpdateAnimalHitRect(a);
+    }
+    return true;
+}
+
+// Returns true when the message disappears
+bool Game::UpdateMessages(float deltaTime) {
+    if (feedbackMessage.timer > 0.0f) {
+        feedbackMessage.timer -= deltaTime;
+        if (feedbackMessage.timer <= 0.0f) {
+            feedbackMessage.text = "";
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Game::SoundFinished(uint32_t play) {
+    // Finished click sounds go back to the pool by themselves; only the
+    // buttons need to notice when their sound ends (or was stolen)
+    for (auto& button : soundButtons) {
+        if (button.isPlaying && button.play == play) {
+            button.isPlaying = false; // Reset to play.png
+            button.play = 0;
+            ++soundboardRevision;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true when the pending animal gets unlocked
+bool Game::UpdateUnlockTimer(float deltaTime) {
+    if (pendingUnlock) {
+        unlockTimer -= deltaTime;
+        if (unlockTimer <= 0.0f) {
+            if (animalToUnlock >= 0) UnlockAnimal(animalToUnlock);
+
+            pendingUnlock = false;
+            animalToUnlock = -1;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Timers only move in whole steps, and the accumulator is already part of the way to the next
+float Game::PendingTime(float timer) const {
+    const float steps = std::ceil(timer / SIM_STEP);
+    return std::max(0.0f, steps * SIM_STEP - accumulator);
+}
+
+float Game::NextTimer() const {
+    float next = -1.0f;
+    if (feedbackMessage.timer > 0.0f) next = PendingTime(feedbackMessage.timer);
+    if (pendingUnlock) {
+        const float unlock = PendingTime(unlockTimer);
+        if (next < 0.0f || unlock < next) next = unlock;
+    }
+    return next;
+}
+
+// Restarts the pop from rest, even if one is running
+void Game::PopAnimal(int a) {
+    animals.flags[a] |= AnimalStore::POPPING;
+    Tween pop;
+    pop.value = &animals.scale[a];
+    pop.previous = &animals.prevScale[a];
+    pop.from = 1.0f;
+    pop.to = POP_SCALE;
+    pop.duration = POP_DURATION;
+    pop.yoyo = true;
+    pop.tag = a;
+    tweens.Start(pop);
+}
+
+// Near the top center; drops into place while fading from white to its color
+void Game::ShowFeedback(const char* text, const MessageColor& color) {
+    feedbackMessage.text = text;
+    feedbackMessage.color = color;
+    feedbackMessage.x = 0.0f;
+    feedbackMessage.y = 0.85f;
+    feedbackMessage.timer = 2.0f;
+
+    Tween slide;
+    slide.value = &feedbackMessage.y;
+    slide.from = feedbackMessage.y + MESSAGE_SLIDE;
+    slide.to = feedbackMessage.y;
+    slide.duration = MESSAGE_INTRO;
+    slide.ease = Ease::BackOut;
+    tweens.Start(slide);
+    feedbackMessage.y = slide.from;
+
+    float* channels[3] = { &feedbackMessage.color.r, &feedbackMessage.color.g, &feedbackMessage.color.b };
+    for (float* channel : channels) {
+        Tween fade;
+        fade.value = channel;
+        fade.from = 1.0f;
+        fade.to = *channel;
+        fade.duration = MESSAGE_INTRO;
+        fade.ease = Ease::QuadOut;
+        tweens.Start(fade);
+        *channel = fade.from;
+    }
+}
+
+// Unlocks an animal together with its sound button
+void Game::UnlockAnimal(int a) {
+    animals.flags[a] |= AnimalStore::UNLOCKED | AnimalStore::SOUND_UNLOCKED;
+    const int b = animals.button[a];
+    if (b >= 0) {
+        soundButtons[b].unlocked = true;
+        UpdateButtonHitRect(b);
+        ++soundboardRevision;
+    }
+}
+
+void Game::HandleClick(float normX, float normY) {
+    const int hit = hitGrid.Query(normX, normY);
+    if (hit < 0) return;
+
+    if (hit < animals.Count()) {
+        const int a = hit;
+        if (animals.Has(a, AnimalStore::UNLOCKED)) {
+            PopAnimal(a);
+
+            // The expected animal is the first unlocked one not yet identified
+            const int expectedAnimal = animals.Expected();
+
+            if (a == expectedAnimal) {
+                ShowFeedback("CORRECT!", { 1.0f, 1.0f, 0.0f });
+                animals.flags[a] |= AnimalStore::FOUND;
+                // Unlock the next animal
+                if (a + 1 < animals.Count()) {
+                    animalToUnlock = a + 1;
+                    pendingUnlock = true;
+                    unlockTimer = 2.0f;  // wait 2 seconds
+                    UnlockAnimal(animalToUnlock);
+                }
+            }
+            else {
+                ShowFeedback("WRONG!", { 1.0f, 0.0f, 0.0f });
+            }
+
+            // Play the clicked animal sound and the feedback sound (correct or incorrect)
+            audio.Play(animals.soundBuffer[a], VoicePriority::Animal);
+            audio.Play((a == expectedAnimal) ? correctSound : incorrectSound,
+                VoicePriority::Feedback);
+        }
+        return;
+    }
+
+    // Sound buttons; a locked button's icon swallows the click
+    SoundButton& button = soundButtons[hit - animals.Count()];
+    if (!button.unlocked) return;
+
+    if (button.isPlaying) {
+        audio.Stop(button.play);
+        button.isPlaying = false;
+        button.play = 0;
+    }
+    else {
+        // Shown as playing right away; the audio thread reports when it ends
+        button.play = audio.Play(button.soundBuffer, VoicePriority::Animal);
+        button.isPlaying = button.play != 0;
+    }
+    ++soundboardRevision;
+}
+
+int Game::FoundCount() const {
+    int found = 0;
+    for (int a = 0; a < animals.Count(); ++a) {
+        if (animals.Has(a, AnimalStore::FOUND)) ++found;
+    }
+    return found;
+}
+
+uint64_t Game::StateHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    HashBytes(hash, animals.flags.data(), animals.flags.size());
+    for (int a = 0; a < animals.Count(); ++a) {
+        HashFloat(hash, animals.scale[a]);
+    }
+    for (const auto& button : soundButtons) {
+        const unsigned char state[2] = { button.unlocked, button.isPlaying };
+        HashBytes(hash, state, sizeof(state));
+    }
+    HashBytes(hash, feedbackMessage.text, strlen(feedbackMessage.text));
+    const unsigned char pending = pendingUnlock;
+    HashBytes(hash, &pending, 1);
+    return hash;
+}
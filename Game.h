@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>                    // uint32_t play ids, uint64_t state hash
+#include <string>                     // Labels and messages
+#include <vector>                     // Sound buttons, per-animal lookups
+
+#include <AL/al.h>                    // ALuint sound buffer handles
+
+#include "AnimalStore.h"             // Animals by handle
+#include "Level.h"                   // LevelDef
+#include "SpatialGrid.h"             // Click hit-testing
+#include "Tween.h"                   // Pop and message animations
+#include "UVRect.h"                  // Sprite coordinates
+
+class AudioSystem;
+
+const float ANIMAL_SIZE = 0.2f;
+const float POP_DURATION = 0.5f;
+const float POP_SCALE = 1.3f;
+const float MESSAGE_SLIDE = 0.1f;     // The feedback text drops this far into place
+const float MESSAGE_INTRO = 0.3f;     // Seconds the slide and color fade take
+const float SIM_STEP = 1.0f / 120.0f;  // Seconds per fixed simulation step
+const float MAX_CATCH_UP = 0.25f;      // Most time simulated in one frame while animating
+
+struct MessageColor {
+    float r = 1.0f;
+    float g = 1.0f;
+    float b = 0.0f;
+};
+
+struct Message {
+    const char* text = "";            // Always a string literal, so showing one never allocates
+    float x = 0.0f;
+    float y = 0.0f;
+    float timer = 0.0f;
+    MessageColor color;
+    float scale = 1.0f;
+};
+
+// One soundboard entry. Positions are in normalized device coordinates.
+struct SoundButton {
+    float x, y, width, height;
+    std::string label;
+    bool isPlaying = false;
+    bool unlocked = false;
+    uint32_t play = 0;                // AudioSystem play id while isPlaying
+    ALuint soundBuffer = 0;
+    float playBtnX, playBtnY;
+    float playBtnSize = 0.08f;
+    float lockX, lockY;
+    int animal = -1;                  // AnimalStore handle this button plays
+};
+
+// The rules of the game with no window, renderer or clock attached: which
+// animal is expected next, what a click does, and the timers that unlock
+// animals and hide messages. The windowed game and the headless replay tool
+// drive the same code, so a recorded session plays out identically in both.
+class Game {
+public:
+    explicit Game(AudioSystem& audio) : audio(audio) {}
+
+    // Running tweens point into this Game's members
+    Game(const Game&) = delete;
+    Game& operator=(const Game&) = delete;
+
+    void SetFeedbackSounds(ALuint correct, ALuint incorrect);
+
+    // Builds the animals and buttons and starts progress over. `sprites` and
+    // `sounds` hold one entry per level animal, in the level's order.
+    void Start(const LevelDef& level, const std::vector<UVRect>& sprites, const std::vector<ALuint>& sounds);
+
+    // normX/normY are the click position in normalized device coordinates.
+    // Only the topmost animal or button under the cursor gets the click.
+    void HandleClick(float normX, float normY);
+
+    // Moves the simulation forward by `frameTime` of wall clock in fixed
+    // SIM_STEP steps, keeping the remainder for the next frame, so the result
+    // doesn't depend on the frame rate. While something animates, no more
+    // than MAX_CATCH_UP is simulated at once: a hitch slows the animation
+    // down instead of skipping it. Idle waits only run timers down and are
+    // caught up in full. Returns true if anything visible changed, or is
+    // still moving between steps. Touches nothing outside this Game, so
+    // several can advance in parallel.
+    bool Advance(float frameTime);
+
+    // One simulation step of any length: every timer, in the main loop's order.
+    // Returns true if anything visible changed. Tools with their own fixed
+    // timestep call this directly.
+    bool Update(float deltaTime);
+
+    // Finished sounds come back through AudioSystem::PollEvent. Several boards
+    // can share one AudioSystem, so the caller polls and hands every finished
+    // play to each of them. Returns true if a button's icon changed.
+    bool SoundFinished(uint32_t play);
+
+    // True while any tween (pops, the feedback message) is running. The main
+    // loop renders every frame at the cap while this holds for any board,
+    // since tweens only move when frames are drawn.
+    bool Animating() const { return !tweens.Empty(); }
+
+    // Seconds until the next timed visible change, or < 0 if none is pending.
+    // Counts the time Advance() is still holding back.
+    float NextTimer() const;
+
+    const AnimalStore& Animals() const { return animals; }
+    const std::vector<SoundButton>& SoundButtons() const { return soundButtons; }
+    const Message& Feedback() const { return feedbackMessage; }
+    // Changes whenever a button is created, unlocks, or starts/stops playing,
+    // i.e. whenever the soundboard looks different
+    unsigned SoundboardRevision() const { return soundboardRevision; }
+
+    // Scales around the sprite center, so the rectangle follows the pop animation
+    void AnimalRect(int a, float& x, float& y, float& size) const;
+    // The same between the last two steps, by how far Advance() is into the
+    // next one. For drawing; clicks test the stepped rectangle.
+    void AnimalDrawRect(int a, float& x, float& y, float& size) const;
+
+    int FoundCount() const;
+    // Folds every animal and button state into one value, for replay regression checks
+    uint64_t StateHash() const;
+
+private:
+    // Returns true when something visible changed
+    bool UpdateAnimations(float deltaTime);
+    bool UpdateMessages(float deltaTime);
+    bool UpdateUnlockTimer(float deltaTime);
+
+    void CreateSoundButtons(const ButtonLayout& layout);
+    void BuildHitGrid();
+    void UpdateButtonHitRect(int b);
+    int ButtonHitId(int button) const { return animals.Count() + button; }
+    void UnlockAnimal(int a);
+    void PopAnimal(int a);
+    void ShowFeedback(const char* text, const MessageColor& color);
+    void UpdateAnimalHitRect(int a);
+    float PendingTime(float timer) const;
+
+    AudioSystem& audio;
+    ALuint correctSound = 0;
+    ALuint incorrectSound = 0;
+
+    AnimalStore animals;
+    std::vector<SoundButton> soundButtons;
+
+    // Every clickable rectangle: animals use their handle as the id, sound
+    // buttons come after them. Depths follow the draw order.
+    SpatialGrid hitGrid;
+
+    // Every running animation. Tweens tagged with an animal handle move that
+    // animal's rectangle; untagged ones animate the feedback message.
+    TweenList tweens;
+    std::vector<int> finishedTweens;  // Scratch for UpdateAnimations()
+
+    bool pendingUnlock = false;
+    float unlockTimer = 0.0f;
+    int animalToUnlock = -1;          // AnimalStore handle
+
+    Message feedbackMessage;
+    unsigned soundboardRevision = 0;
+
+    float accumulator = 0.0f;         // Wall clock not simulated yet, < SIM_STEP after Advance()
+};
@@ -0,0 +1,60 @@
+#include "InputScript.h"
+
+#include <iomanip>                    // Fixed-point times in recordings
+#include <iostream>                   // Error output
+#include <sstream>                    // Per-line parsing
+#include <string>                     // Lines and event names
+
+bool LoadInputScript(const char* filepath, std::vector<ScriptedClick>& out) {
+    std::ifstream file(filepath);
+    if (!file) {
+        std::cerr << "Failed to open input script: " << filepath << std::endl;
+        return false;
+    }
+
+    std::vector<ScriptedClick> clicks;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        std::istringstream fields(line);
+        ScriptedClick click;
+        std::string event;
+        if (!(fields >> click.time >> event) || event != "click" || !(fields >> click.x >> click.y)) {
+            std::cerr << filepath << ":" << lineNumber << ": expected '<seconds> click <x> <y>'" << std::endl;
+            return false;
+        }
+        if (!clicks.empty() && click.time < clicks.back().time) {
+            std::cerr << filepath << ":" << lineNumber << ": clicks must be in time order" << std::endl;
+            return false;
+        }
+        clicks.push_back(click);
+    }
+
+    out.swap(clicks);
+    return true;
+}
+
+bool InputRecorder::Open(const char* filepath) {
+    file.open(filepath, std::ios::out | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Failed to open " << filepath << " for recording" << std::endl;
+        return false;
+    }
+    file << "# seconds event x y\n";
+    return true;
+}
+
+void InputRecorder::Close() {
+    if (file.is_open()) file.close();
+}
+
+void InputRecorder::Click(double time, float x, float y) {
+    if (!file.is_open()) return;
+    file << std::fixed << std::setprecision(4) << time << " click "
+         << std::setprecision(6) << x << ' ' << y << '\n';
+    file.flush();  // A session that crashes still leaves its script behind
+}
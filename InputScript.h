@@ -0,0 +1,36 @@
+#pragma once
+
+#include <fstream>                    // Recording
+#include <vector>                     // Loaded clicks
+
+// One left click, in normalized device coordinates. `time` is in seconds
+// from the start of the session.
+struct ScriptedClick {
+    double time = 0.0;
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+// Input scripts are plain text, one event per line:
+//
+//     # seconds  event  x      y
+//     1.25       click  0.31   -0.42
+//
+// Blank lines and lines starting with '#' are skipped. Clicks must be in
+// time order. Errors are reported with the file name and line, and `out` is
+// left untouched on failure.
+bool LoadInputScript(const char* filepath, std::vector<ScriptedClick>& out);
+
+// Writes the clicks of a live session in the format LoadInputScript() reads,
+// so a bug seen in the game can be replayed by the headless build
+class InputRecorder {
+public:
+    bool Open(const char* filepath);
+    void Close();
+
+    // Does nothing unless a file is open
+    void Click(double time, float x, float y);
+
+private:
+    std::ofstream file;
+};
@@ -0,0 +1,234 @@
+#include "Json.h"
+
+#include <cstdlib>                    // strtod
+
+namespace {
+
+class Parser {
+public:
+    explicit Parser(const std::string& text) : text(text) {}
+
+    bool Parse(JsonValue& out, std::string& error) {
+        SkipWhitespace();
+        if (!ParseValue(out, 0)) {
+            error = message;
+            return false;
+        }
+        SkipWhitespace();
+        if (pos != text.size()) {
+            Fail("unexpected text after the document");
+            error = message;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static const int MAX_DEPTH = 64;
+
+    bool Fail(const char* what) {
+        int line = 1;
+        for (size_t i = 0; i < pos && i < text.size(); ++i) {
+            if (text[i] == '\n') ++line;
+        }
+        message = "line " + std::to_string(line) + ": " + what;
+        return false;
+    }
+
+    void SkipWhitespace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            ++pos;
+        }
+    }
+
+    bool Consume(const char* word) {
+        size_t i = 0;
+        while (word[i]) {
+            if (pos + i >= text.size() || text[pos + i] != word[i]) return false;
+            ++i;
+        }
+        pos += i;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& out, int depth) {
+        if (depth > MAX_DEPTH) return Fail("nested too deeply");
+        if (pos >= text.size()) return Fail("unexpected end of file");
+
+        switch (text[pos]) {
+        case '{': return ParseObject(out, depth);
+        case '[': return ParseArray(out, depth);
+        case '"':
+            out.type = JsonValue::Type::String;
+            return ParseString(out.string);
+        case 't':
+        case 'f':
+            out.type = JsonValue::Type::Bool;
+            out.boolean = text[pos] == 't';
+            if (Consume(out.boolean ? "true" : "false")) return true;
+            return Fail("expected true or false");
+        case 'n':
+            out.type = JsonValue::Type::Null;
+            if (Consume("null")) return true;
+            return Fail("expected null");
+        default:
+            return ParseNumber(out);
+        }
+    }
+
+    bool ParseNumber(JsonValue& out) {
+        const size_t start = pos;
+        if (pos < text.size() && text[pos] == '-') ++pos;
+        if (pos >= text.size() || text[pos] < '0' || text[pos] > '9') return Fail("expected a value");
+        while (pos < text.size() && ((text[pos] >= '0' && text[pos] <= '9') || text[pos] == '.' ||
+            text[pos] == 'e' || text[pos] == 'E' || text[pos] == '+' || text[pos] == '-')) {
+            ++pos;
+        }
+
+        const std::string digits = text.substr(start, pos - start);
+        char* end = nullptr;
+        out.type = JsonValue::Type::Number;
+        out.number = strtod(digits.c_str(), &end);
+        if (end != digits.c_str() + digits.size()) {
+            pos = start;
+            return Fail("malformed number");
+        }
+        return true;
+    }
+
+    bool ParseString(std::string& out) {
+        ++pos;  // Opening quote
+        out.clear();
+        while (pos < text.size()) {
+            const char c = text[pos++];
+            if (c == '"') return true;
+            if (static_cast<unsigned char>(c) < 0x20) return Fail("control character in string");
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+
+            if (pos >= text.size()) break;
+            const char escape = text[pos++];
+            switch (escape) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (pos + 4 > text.size()) return Fail("truncated \\u escape");
+                unsigned code = 0;
+                for (int i = 0; i < 4; ++i) {
+                    const char h = text[pos++];
+                    code <<= 4;
+                    if (h >= '0' && h <= '9') code |= h - '0';
+                    else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+                    else return Fail("bad \\u escape");
+                }
+                // UTF-8 encode; surrogate pairs aren't needed for paths and names
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                }
+                else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return Fail("unknown escape in string");
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ParseArray(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Array;
+        ++pos;  // [
+        SkipWhitespace();
+        if (pos < text.size() && text[pos] == ']') {
+            ++pos;
+            return true;
+        }
+
+        for (;;) {
+            out.array.emplace_back();
+            SkipWhitespace();
+            if (!ParseValue(out.array.back(), depth + 1)) return false;
+            SkipWhitespace();
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return true;
+            }
+            return Fail("expected ',' or ']'");
+        }
+    }
+
+    bool ParseObject(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Object;
+        ++pos;  // {
+        SkipWhitespace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return true;
+        }
+
+        for (;;) {
+            SkipWhitespace();
+            if (pos >= text.size() || text[pos] != '"') return Fail("expected a member name");
+            out.object.emplace_back();
+            if (!ParseString(out.object.back().first)) return false;
+
+            SkipWhitespace();
+            if (pos >= text.size() || text[pos] != ':') return Fail("expected ':'");
+            ++pos;
+            SkipWhitespace();
+            if (!ParseValue(out.object.back().second, depth + 1)) return false;
+
+            SkipWhitespace();
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            return Fail("expected ',' or '}'");
+        }
+    }
+
+    const std::string& text;
+    size_t pos = 0;
+    std::string message;
+};
+
+} // namespace
+
+const JsonValue* JsonValue::Find(const std::string& key) const {
+    if (type != Type::Object) return nullptr;
+    for (const auto& member : object) {
+        if (member.first == key) return &member.second;
+    }
+    return nullptr;
+}
+
+bool ParseJson(const std::string& text, JsonValue& out, std::string& error) {
+    out = JsonValue();
+    Parser parser(text);
+    return parser.Parse(out, error);
+}
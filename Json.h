@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>                     // Keys and string values
+#include <utility>                    // std::pair for object members
+#include <vector>                     // Arrays and objects
+
+// Parsed JSON document. Objects keep their members in file order, so error
+// messages and round trips stay predictable.
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object } type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    // nullptr if this isn't an object or has no such member
+    const JsonValue* Find(const std::string& key) const;
+};
+
+// Strict RFC 8259 parser, small enough for level files. On failure `error`
+// says what went wrong and on which line.
+bool ParseJson(const std::string& text, JsonValue& out, std::string& error);
@@ -0,0 +1,136 @@
+#include "LatencyTracker.h"
+
+#include <algorithm>                  // std::sort
+#include <chrono>                     // steady_clock
+#include <cmath>                      // std::ceil
+#include <cstdio>                     // snprintf for report lines
+#include <iostream>                   // Error reporting
+
+namespace {
+
+const char* STAGE_NAMES[] = { "input", "queue", "output", "total" };
+
+// Milliseconds from `from` to `to`, or negative if either wasn't stamped
+double StageMs(double from, double to) {
+    if (from < 0.0 || to < 0.0) return -1.0;
+    return (to - from) * 1000.0;
+}
+
+// Nearest-rank percentile of sorted values
+double Rank(const std::vector<double>& sorted, double percent) {
+    const size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * sorted.size()));
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+} // namespace
+
+double LatencyNow() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LatencyTracker::LatencyTracker() {
+    for (Window& window : windows) window.ms.reserve(WINDOW);
+    sorted.reserve(WINDOW);
+}
+
+void LatencyTracker::Add(const LatencySample& sample) {
+    const double ms[STAGE_COUNT] = {
+        StageMs(sample.input, sample.posted),
+        StageMs(sample.posted, sample.issued),
+        StageMs(sample.issued, sample.heard),
+        StageMs(sample.input, sample.heard),
+    };
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        if (ms[stage] < 0.0) continue;
+
+        Window& window = windows[stage];
+        if (window.ms.size() < static_cast<size_t>(WINDOW)) {
+            window.ms.push_back(ms[stage]);
+        }
+        else {
+            window.ms[window.next] = ms[stage];
+        }
+        window.next = (window.next + 1) % WINDOW;
+    }
+    ++added;
+
+    if (log.is_open()) {
+        log << sample.play;
+        for (double value : ms) {
+            log << ',';
+            if (value >= 0.0) log << value;
+        }
+        log << '\n';
+    }
+}
+
+bool LatencyTracker::OpenLog(const char* filepath) {
+    CloseLog();
+    log.open(filepath, std::ios::out | std::ios::trunc);
+    if (!log) {
+        std::cerr << "Failed to open latency log: " << filepath << std::endl;
+        return false;
+    }
+    log << "play";
+    for (const char* name : STAGE_NAMES) {
+        log << ',' << name << "_ms";
+    }
+    log << '\n';
+    return true;
+}
+
+void LatencyTracker::CloseLog() {
+    if (!log.is_open()) return;
+
+    // Comment lines, so the rows above still load as plain CSV
+    char line[96];
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        double p50, p95, p99;
+        if (!Percentiles(static_cast<Stage>(stage), p50, p95, p99)) continue;
+        std::snprintf(line, sizeof(line), "# %s p50 %.2f p95 %.2f p99 %.2f ms", STAGE_NAMES[stage], p50, p95, p99);
+        log << line << '\n';
+    }
+    log.close();
+}
+
+bool LatencyTracker::Percentiles(Stage stage, double& p50, double& p95, double& p99) const {
+    if (windows[stage].ms.empty()) return false;
+
+    sorted.assign(windows[stage].ms.begin(), windows[stage].ms.end());
+    std::sort(sorted.begin(), sorted.end());
+    p50 = Rank(sorted, 50.0);
+    p95 = Rank(sorted, 95.0);
+    p99 = Rank(sorted, 99.0);
+    return true;
+}
+
+void LatencyTracker::OverlayLines(std::vector<std::string>& lines) const {
+    lines.resize(1 + STAGE_COUNT);
+    char line[96];
+    std::snprintf(line, sizeof(line), "%-8s    P50    P95    P99", "LATENCY");
+    lines[0] = line;
+
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        double p50, p95, p99;
+        if (Percentiles(static_cast<Stage>(stage), p50, p95, p99)) {
+            std::snprintf(line, sizeof(line), "%-8s %6.1f %6.1f %6.1f", STAGE_NAMES[stage], p50, p95, p99);
+        }
+        else {
+            std::snprintf(line, sizeof(line), "%-8s      -      -      -", STAGE_NAMES[stage]);
+        }
+        lines[1 + stage] = line;
+    }
+}
+
+std::string LatencyTracker::Summary() const {
+    double p50, p95, p99;
+    char line[128];
+    if (Percentiles(STAGE_TOTAL, p50, p95, p99)) {
+        std::snprintf(line, sizeof(line), "Click-to-sound latency over the last %d plays: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms",
+            static_cast<int>(windows[STAGE_TOTAL].ms.size()), p50, p95, p99);
+    }
+    else {
+        std::snprintf(line, sizeof(line), "Click-to-sound latency: no device timings over %d plays", added);
+    }
+    return line;
+}
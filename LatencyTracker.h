@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>                    // uint32_t play ids
+#include <fstream>                    // Log file
+#include <string>                     // Overlay lines
+#include <vector>                     // Sample windows
+
+// Seconds on steady_clock. Every latency stamp uses this clock, whichever
+// thread (game, audio, device callback) takes it.
+double LatencyNow();
+
+// When each stage of one click's sound happened, in LatencyNow() seconds;
+// negative where a stage wasn't seen
+struct LatencySample {
+    uint32_t play = 0;
+    double input = -1.0;              // The input event arrived from the OS
+    double posted = -1.0;             // Game logic posted the play
+    double issued = -1.0;             // The audio thread started a voice
+    double heard = -1.0;              // The backend's estimate of the first sample leaving the device
+};
+
+// Collects the stage-to-stage delays of the last WINDOW plays and reports
+// their percentiles, for the profiler overlay and a log file. Stages:
+//   input   input event -> play posted (main loop wait plus game logic)
+//   queue   play posted -> voice started on the audio thread
+//   output  voice started -> heard, as reported by the backend
+//   total   input event -> heard
+// Game thread only.
+class LatencyTracker {
+public:
+    static const int WINDOW = 256;
+
+    LatencyTracker();
+
+    void Add(const LatencySample& sample);
+    int Samples() const { return added; }
+
+    // Writes one CSV row per play, then the percentiles when closed
+    bool OpenLog(const char* filepath);
+    void CloseLog();
+    bool Logging() const { return log.is_open(); }
+
+    // A header and one row per stage, p50/p95/p99 in milliseconds. Reuses
+    // the strings already in `lines`, so refreshing them doesn't allocate.
+    void OverlayLines(std::vector<std::string>& lines) const;
+    // The total stage on one line, for the console
+    std::string Summary() const;
+
+private:
+    enum Stage { STAGE_INPUT, STAGE_QUEUE, STAGE_OUTPUT, STAGE_TOTAL, STAGE_COUNT };
+
+    struct Window {
+        std::vector<double> ms;       // Ring of the last WINDOW values
+        size_t next = 0;
+    };
+
+    // false if the stage has no samples yet
+    bool Percentiles(Stage stage, double& p50, double& p95, double& p99) const;
+
+    Window windows[STAGE_COUNT];
+    mutable std::vector<double> sorted;  // Percentiles() scratch
+    int added = 0;
+    std::ofstream log;
+};
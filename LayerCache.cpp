@@ -0,0 +1,78 @@
+#include "LayerCache.h"
+
+#include <iostream>                   // Error reporting
+
+bool LayerCache::Supported() {
+    return GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object;
+}
+
+bool LayerCache::Resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height) return framebuffer != 0;
+
+    Release();
+    width = newWidth;
+    height = newHeight;
+    dirty = true;
+    if (width <= 0 || height <= 0 || !Supported()) return false;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    // Composited texel for pixel, so the filter never blends neighbours
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Layer framebuffer incomplete (0x" << std::hex << status << std::dec
+                  << "), drawing layers directly" << std::endl;
+        Release();
+        width = newWidth;             // Not retried until the size changes
+        height = newHeight;
+        return false;
+    }
+    return true;
+}
+
+void LayerCache::Begin() {
+    glGetIntegerv(GL_VIEWPORT, savedViewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void LayerCache::End() {
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+    dirty = false;
+}
+
+UVRect LayerCache::CompositeUV() {
+    UVRect flipped;
+    flipped.v0 = 1.0f;
+    flipped.v1 = 0.0f;
+    return flipped;
+}
+
+void LayerCache::Release() {
+    if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+    if (texture) glDeleteTextures(1, &texture);
+    framebuffer = texture = 0;
+    width = height = 0;
+    dirty = true;
+}
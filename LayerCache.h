@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glew.h>                     // Framebuffer object and its texture
+
+#include "UVRect.h"                  // Composite coordinates
+
+// An offscreen copy of the part of the scene that rarely changes (the
+// background and the soundboard), in a texture the size of the viewport it
+// covers. The layer is drawn into the texture only when it's dirty; every
+// other frame it goes on screen as one opaque quad, so the full-screen
+// background isn't filled again frame after frame.
+//
+// Needs framebuffer objects (GL 3.0 or ARB_framebuffer_object). Without them
+// Resize() fails and the caller draws the layer directly instead.
+class LayerCache {
+public:
+    static bool Supported();
+
+    // Reallocates the texture when the size changes, which also marks the
+    // layer dirty. Returns false if the layer can't be used at this size.
+    bool Resize(int width, int height);
+
+    void Invalidate() { dirty = true; }
+    bool Dirty() const { return dirty; }
+
+    // Redirects drawing into the layer, with a viewport covering all of it.
+    // Assumes the game's glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // coverage is added to the alpha channel instead, so the layer stays
+    // opaque wherever it has been drawn.
+    void Begin();
+    // Back to the window with the viewport from before Begin(); the layer is clean
+    void End();
+
+    GLuint Texture() const { return texture; }
+    // Render targets store the bottom row first, unlike images
+    static UVRect CompositeUV();
+
+    // The GL context must still be current
+    void Release();
+
+private:
+    GLuint framebuffer = 0;
+    GLuint texture = 0;
+    int width = 0;
+    int height = 0;
+    GLint savedViewport[4] = {};
+    bool dirty = true;
+};
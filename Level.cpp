@@ -0,0 +1,118 @@
+#include "Level.h"
+
+#include <fstream>                    // Level file input
+#include <iostream>                   // Error reporting
+#include <set>                        // Duplicate id check
+#include <sstream>                    // Whole-file read
+
+#include <sys/stat.h>                 // File modification times
+
+#include "Json.h"                    // Level file format
+
+namespace {
+
+bool ReadString(const JsonValue& object, const char* key, std::string& out, bool required) {
+    const JsonValue* value = object.Find(key);
+    if (!value) return !required;
+    if (value->type != JsonValue::Type::String) return false;
+    out = value->string;
+    return true;
+}
+
+bool ReadFloat(const JsonValue& object, const char* key, float& out, bool required) {
+    const JsonValue* value = object.Find(key);
+    if (!value) return !required;
+    if (value->type != JsonValue::Type::Number) return false;
+    out = static_cast<float>(value->number);
+    return true;
+}
+
+bool ReadBool(const JsonValue& object, const char* key, bool& out) {
+    const JsonValue* value = object.Find(key);
+    if (!value) return true;
+    if (value->type != JsonValue::Type::Bool) return false;
+    out = value->boolean;
+    return true;
+}
+
+} // namespace
+
+bool LoadLevel(const char* filepath, LevelDef& out) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open level file: " << filepath << std::endl;
+        return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    JsonValue root;
+    std::string error;
+    if (!ParseJson(contents.str(), root, error)) {
+        std::cerr << filepath << ": " << error << std::endl;
+        return false;
+    }
+    if (root.type != JsonValue::Type::Object) {
+        std::cerr << filepath << ": expected an object at the top level" << std::endl;
+        return false;
+    }
+
+    LevelDef level;
+    if (!ReadString(root, "background", level.background, true) ||
+        !ReadString(root, "soundboard", level.soundboard, true)) {
+        std::cerr << filepath << ": \"background\" and \"soundboard\" must be image paths" << std::endl;
+        return false;
+    }
+
+    if (const JsonValue* buttons = root.Find("buttons")) {
+        if (!ReadFloat(*buttons, "top", level.buttons.top, false) ||
+            !ReadFloat(*buttons, "bottom", level.buttons.bottom, false) ||
+            !ReadFloat(*buttons, "gap", level.buttons.gap, false)) {
+            std::cerr << filepath << ": \"buttons\" values must be numbers" << std::endl;
+            return false;
+        }
+    }
+
+    const JsonValue* animals = root.Find("animals");
+    if (!animals || animals->type != JsonValue::Type::Array || animals->array.empty()) {
+        std::cerr << filepath << ": \"animals\" must be a non-empty array" << std::endl;
+        return false;
+    }
+
+    std::set<std::string> ids;
+    for (size_t i = 0; i < animals->array.size(); ++i) {
+        const JsonValue& entry = animals->array[i];
+        AnimalDef animal;
+        if (entry.type != JsonValue::Type::Object ||
+            !ReadString(entry, "id", animal.id, true) ||
+            !ReadString(entry, "name", animal.displayName, true) ||
+            !ReadString(entry, "sprite", animal.sprite, true) ||
+            !ReadString(entry, "sound", animal.sound, true) ||
+            !ReadFloat(entry, "x", animal.x, true) ||
+            !ReadFloat(entry, "y", animal.y, true) ||
+            !ReadBool(entry, "unlocked", animal.unlocked)) {
+            std::cerr << filepath << ": animal " << i
+                << " needs string id/name/sprite/sound, numeric x/y and an optional bool unlocked" << std::endl;
+            return false;
+        }
+        if (!ids.insert(animal.id).second) {
+            std::cerr << filepath << ": duplicate animal id \"" << animal.id << "\"" << std::endl;
+            return false;
+        }
+        level.animals.push_back(animal);
+    }
+
+    out = level;
+    return true;
+}
+
+long long FileModifiedTime(const std::string& filepath) {
+#ifdef _WIN32
+    struct _stat64 info;
+    if (_stat64(filepath.c_str(), &info) != 0) return 0;
+#else
+    struct stat info;
+    if (stat(filepath.c_str(), &info) != 0) return 0;
+#endif
+    return static_cast<long long>(info.st_mtime);
+}
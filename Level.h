@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>                     // Paths and names
+#include <vector>                     // Animal list
+
+// One hideable animal. The sprite and sound paths are what AssetLoader
+// loads; `id` is what the game logic refers to the animal by.
+struct AnimalDef {
+    std::string id;
+    std::string displayName;          // Sound button label
+    std::string sprite;
+    std::string sound;
+    float x = 0.0f;                   // Bottom-left corner, normalized device coordinates
+    float y = 0.0f;
+    bool unlocked = false;            // Available from the start
+};
+
+// Vertical extent of the sound button column on the soundboard, in NDC
+struct ButtonLayout {
+    float top = 0.45f;
+    float bottom = -0.85f;
+    float gap = 0.04f;
+};
+
+// Everything a level file describes. The animals array order is the order
+// they unlock in.
+struct LevelDef {
+    std::string background;
+    std::string soundboard;
+    ButtonLayout buttons;
+    std::vector<AnimalDef> animals;
+};
+
+// Reads a JSON level file, e.g. assets/level1.json. Errors are reported with
+// the file name and line, and `out` is left untouched on failure.
+bool LoadLevel(const char* filepath, LevelDef& out);
+
+// Last-modified time in seconds, or 0 if the file doesn't exist. Used to
+// notice edits to the level and the assets it references.
+long long FileModifiedTime(const std::string& filepath);
@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+
+#include <iostream>                   // Error reporting
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>                  // CreateFileMapping, MapViewOfFile
+#else
+#include <fcntl.h>                    // open
+#include <sys/mman.h>                 // mmap, munmap
+#include <sys/stat.h>                 // fstat
+#include <unistd.h>                   // close
+#endif
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* filepath) {
+    Close();
+
+    HANDLE handle = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open file: " << filepath << std::endl;
+        return false;
+    }
+    file = handle;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0) {
+        std::cerr << "Empty or unreadable file: " << filepath << std::endl;
+        Close();
+        return false;
+    }
+
+    mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        std::cerr << "Failed to map file: " << filepath << std::endl;
+        Close();
+        return false;
+    }
+
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        std::cerr << "Failed to map file: " << filepath << std::endl;
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (file) CloseHandle(file);
+    data = nullptr;
+    mapping = nullptr;
+    file = nullptr;
+    size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const char* filepath) {
+    Close();
+
+    fd = open(filepath, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open file: " << filepath << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        std::cerr << "Empty or unreadable file: " << filepath << std::endl;
+        Close();
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "Failed to map file: " << filepath << std::endl;
+        Close();
+        return false;
+    }
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap(const_cast<unsigned char*>(data), size);
+    if (fd >= 0) close(fd);
+    data = nullptr;
+    size = 0;
+    fd = -1;
+}
+
+#endif
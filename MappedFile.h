@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+
+// Read-only memory mapping of a whole file. Pages are loaded by the OS on
+// first touch, so opening is cheap and nothing is copied into our own heap.
+// Works on Windows (file mapping objects) and POSIX (mmap).
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const char* filepath);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;             // HANDLE, kept out of the header to avoid <windows.h>
+    void* mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
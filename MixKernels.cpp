@@ -0,0 +1,65 @@
+#include "MixKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIX_SSE2 1
+#include <emmintrin.h>                // SSE2 intrinsics
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define MIX_NEON 1
+#include <arm_neon.h>                 // NEON intrinsics
+#endif
+
+void MixStereo(float* dst, const float* src, size_t frames, float gain) {
+    const size_t count = frames * 2;
+    size_t i = 0;
+#if defined(MIX_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    }
+#elif defined(MIX_NEON)
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+void MixMonoToStereo(float* dst, const float* src, size_t frames, float gain) {
+    size_t i = 0;
+#if defined(MIX_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 4 <= frames; i += 4) {
+        const __m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+        float* out = dst + i * 2;
+        _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(s, s)));          // s0 s0 s1 s1
+        _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(s, s)));  // s2 s2 s3 s3
+    }
+#elif defined(MIX_NEON)
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 4 <= frames; i += 4) {
+        const float32x4_t s = vmulq_f32(vld1q_f32(src + i), g);
+        const float32x4x2_t both = vzipq_f32(s, s);
+        float* out = dst + i * 2;
+        vst1q_f32(out, vaddq_f32(vld1q_f32(out), both.val[0]));
+        vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), both.val[1]));
+    }
+#endif
+    for (; i < frames; ++i) {
+        const float s = src[i] * gain;
+        dst[i * 2] += s;
+        dst[i * 2 + 1] += s;
+    }
+}
+
+const char* MixKernelName() {
+#if defined(MIX_SSE2)
+    return "sse2";
+#elif defined(MIX_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+
+// Inner loops of the software mixer. `dst` is interleaved stereo float and
+// is accumulated into, not overwritten. SSE2 or NEON where the target has
+// it, with a scalar loop for the tail and everything else.
+
+// dst[i] += src[i] * gain over frames * 2 floats
+void MixStereo(float* dst, const float* src, size_t frames, float gain);
+// Both channels of dst frame i get src[i] * gain
+void MixMonoToStereo(float* dst, const float* src, size_t frames, float gain);
+
+// "sse2", "neon" or "scalar", for logs and benchmarks
+const char* MixKernelName();
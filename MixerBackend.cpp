@@ -0,0 +1,366 @@
+#include "MixerBackend.h"
+
+#include <algorithm>                  // std::fill, std::min, std::remove_if
+#include <chrono>                     // Refill and callback waits
+#include <iostream>                   // Error reporting
+
+// Must match the options AudioDecoder.cpp builds the implementation with
+#define MA_NO_ENCODING
+#define MA_NO_GENERATION
+#include "miniaudio.h"               // Device I/O, format conversion, decoding
+
+#include "LatencyTracker.h"          // LatencyNow() for heard times
+#include "MixKernels.h"              // SIMD mix loops
+
+struct MixerBackend::MusicRing {
+    ma_pcm_rb rb;
+};
+
+namespace {
+
+void DataCallback(ma_device* device, void* output, const void*, ma_uint32 frameCount) {
+    static_cast<MixerBackend*>(device->pUserData)->Mix(static_cast<float*>(output), frameCount);
+}
+
+// Inverse of PcmFormat()
+bool SplitFormat(ALenum format, unsigned& channels, ma_format& sampleFormat) {
+    switch (format) {
+    case AL_FORMAT_MONO8:    channels = 1; sampleFormat = ma_format_u8; return true;
+    case AL_FORMAT_MONO16:   channels = 1; sampleFormat = ma_format_s16; return true;
+    case AL_FORMAT_STEREO8:  channels = 2; sampleFormat = ma_format_u8; return true;
+    case AL_FORMAT_STEREO16: channels = 2; sampleFormat = ma_format_s16; return true;
+    default: return false;
+    }
+}
+
+} // namespace
+
+MixerBackend::MixerBackend() {
+}
+
+MixerBackend::~MixerBackend() {
+    Shutdown();
+}
+
+bool MixerBackend::Init(const AudioBackendConfig& config) {
+    const int count = std::max(1, config.voices);
+    voices.assign(count, Voice());
+    startedSerial.assign(count, 0);
+    doneSerial.reset(new std::atomic<uint32_t>[count]);
+    mixedSerial.reset(new std::atomic<uint32_t>[count]);
+    mixedHeardAt.reset(new std::atomic<double>[count]);
+    for (int i = 0; i < count; ++i) {
+        doneSerial[i].store(0);
+        mixedSerial[i].store(0);
+        mixedHeardAt[i].store(0.0);
+    }
+
+    ma_device_config deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format = ma_format_f32;
+    deviceConfig.playback.channels = 2;
+    deviceConfig.sampleRate = config.sampleRate;
+    deviceConfig.periodSizeInMilliseconds = config.periodMs;
+    deviceConfig.performanceProfile = ma_performance_profile_low_latency;
+    deviceConfig.dataCallback = DataCallback;
+    deviceConfig.pUserData = this;
+
+    device.reset(new ma_device);
+    if (ma_device_init(NULL, &deviceConfig, device.get()) != MA_SUCCESS) {
+        std::cerr << "Failed to open audio device for the mixer" << std::endl;
+        device.reset();
+        return false;
+    }
+    sampleRate = device->sampleRate;
+    // What a callback writes is heard once the periods queued before it have played
+    outputLatency = static_cast<double>(device->playback.internalPeriodSizeInFrames)
+        * device->playback.internalPeriods / device->playback.internalSampleRate;
+
+    if (ma_device_start(device.get()) != MA_SUCCESS) {
+        std::cerr << "Failed to start audio device for the mixer" << std::endl;
+        ma_device_uninit(device.get());
+        device.reset();
+        return false;
+    }
+    deviceStarted = true;
+
+    std::cout << "Audio mixer: " << sampleRate << " Hz, " << device->playback.internalPeriodSizeInFrames
+        << "-frame period, " << outputLatency * 1000.0 << " ms queued, " << MixKernelName() << " kernels" << std::endl;
+    return true;
+}
+
+void MixerBackend::Shutdown() {
+    StopMusic();
+    if (device) {
+        ma_device_uninit(device.get());  // Returns once the callback has stopped
+        device.reset();
+    }
+    deviceStarted = false;
+
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    FreeRetired(true);
+    buffers.clear();
+    voices.clear();
+    startedSerial.clear();
+    doneSerial.reset();
+    mixedSerial.reset();
+    mixedHeardAt.reset();
+}
+
+ALuint MixerBackend::CreateBuffer(ALenum format, const void* data, size_t size, unsigned rate,
+    const char* name, bool) {
+    unsigned channels;
+    ma_format sampleFormat;
+    if (!SplitFormat(format, channels, sampleFormat) || !sampleRate) {
+        std::cerr << "Unsupported sound format for the mixer: " << name << std::endl;
+        return 0;
+    }
+
+    // Resampled once here so the callback never has to
+    const ma_uint64 framesIn = size / (channels * ma_get_bytes_per_sample(sampleFormat));
+    const ma_uint64 framesOut = ma_convert_frames(NULL, 0, ma_format_f32, channels, sampleRate,
+        data, framesIn, sampleFormat, channels, rate);
+    if (framesOut == 0) {
+        std::cerr << "Failed to convert sound for the mixer: " << name << std::endl;
+        return 0;
+    }
+
+    std::unique_ptr<MixBuffer> buffer(new MixBuffer);
+    buffer->channels = channels;
+    buffer->samples.resize(static_cast<size_t>(framesOut) * channels);
+    buffer->frames = static_cast<size_t>(ma_convert_frames(buffer->samples.data(), framesOut, ma_format_f32,
+        channels, sampleRate, data, framesIn, sampleFormat, channels, rate));
+
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    FreeRetired(false);
+    buffers.push_back(std::move(buffer));
+    return static_cast<ALuint>(buffers.size());
+}
+
+void MixerBackend::DeleteBuffer(ALuint buffer) {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    if (buffer == 0 || buffer > buffers.size() || !buffers[buffer - 1]) return;
+
+    // The callback may not have seen the stop for the last voice that played it yet
+    Retired entry;
+    entry.buffer = std::move(buffers[buffer - 1]);
+    entry.epoch = epoch.load(std::memory_order_acquire);
+    if (deviceStarted) retired.push_back(std::move(entry));
+    FreeRetired(false);
+}
+
+// Needs bufferMutex held
+void MixerBackend::FreeRetired(bool all) {
+    const uint64_t now = epoch.load(std::memory_order_acquire);
+    retired.erase(std::remove_if(retired.begin(), retired.end(), [&](const Retired& entry) {
+        return all || now >= entry.epoch + 2;
+    }), retired.end());
+}
+
+void MixerBackend::WaitForCallbacks(uint64_t count) {
+    const uint64_t target = epoch.load(std::memory_order_acquire) + count;
+    // Bounded, in case the device stopped by itself
+    for (int i = 0; i < 500 && deviceStarted && epoch.load(std::memory_order_acquire) < target; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void MixerBackend::PostVoice(const VoiceCommand& command) {
+    // The callback drains the queue every period, so a full queue clears quickly
+    while (!voiceCommands.Push(command)) {
+        std::this_thread::yield();
+    }
+}
+
+void MixerBackend::StartVoice(int voice, ALuint buffer, float gain) {
+    const MixBuffer* samples = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        if (buffer > 0 && buffer <= buffers.size()) samples = buffers[buffer - 1].get();
+    }
+    if (!samples) {
+        StopVoice(voice);
+        return;
+    }
+
+    VoiceCommand command;
+    command.type = VoiceCommand::Type::Start;
+    command.voice = voice;
+    command.buffer = samples;
+    command.gain = gain;
+    command.serial = ++startedSerial[voice];
+    PostVoice(command);
+}
+
+void MixerBackend::StopVoice(int voice) {
+    VoiceCommand command;
+    command.type = VoiceCommand::Type::Stop;
+    command.voice = voice;
+    PostVoice(command);
+}
+
+void MixerBackend::SetVoiceGain(int voice, float gain) {
+    VoiceCommand command;
+    command.type = VoiceCommand::Type::Gain;
+    command.voice = voice;
+    command.gain = gain;
+    PostVoice(command);
+}
+
+// Playing until the callback reports the latest start as done
+bool MixerBackend::VoicePlaying(int voice) const {
+    return doneSerial[voice].load(std::memory_order_acquire) != startedSerial[voice];
+}
+
+bool MixerBackend::VoiceHeardAt(int voice, double& time) const {
+    if (mixedSerial[voice].load(std::memory_order_acquire) != startedSerial[voice]) return false;
+    time = mixedHeardAt[voice].load(std::memory_order_relaxed);
+    return true;
+}
+
+void MixerBackend::Mix(float* out, uint32_t frames) {
+    const double heardAt = LatencyNow() + outputLatency;
+    VoiceCommand command;
+    while (voiceCommands.Pop(command)) {
+        Voice& voice = voices[command.voice];
+        switch (command.type) {
+        case VoiceCommand::Type::Start:
+            voice.buffer = command.buffer;
+            voice.cursor = 0;
+            voice.gain = command.gain;
+            voice.serial = command.serial;
+            // Mixed from the first frame of this period onwards
+            mixedHeardAt[command.voice].store(heardAt, std::memory_order_relaxed);
+            mixedSerial[command.voice].store(command.serial, std::memory_order_release);
+            break;
+        case VoiceCommand::Type::Stop:
+            if (voice.buffer) {
+                voice.buffer = nullptr;
+                doneSerial[command.voice].store(voice.serial, std::memory_order_release);
+            }
+            break;
+        case VoiceCommand::Type::Gain:
+            voice.gain = command.gain;
+            break;
+        }
+    }
+
+    std::fill(out, out + static_cast<size_t>(frames) * 2, 0.0f);
+
+    for (size_t i = 0; i < voices.size(); ++i) {
+        Voice& voice = voices[i];
+        if (!voice.buffer) continue;
+
+        const MixBuffer& buffer = *voice.buffer;
+        const size_t count = std::min<size_t>(frames, buffer.frames - voice.cursor);
+        const float* src = buffer.samples.data() + voice.cursor * buffer.channels;
+        if (buffer.channels == 2) MixStereo(out, src, count, voice.gain);
+        else MixMonoToStereo(out, src, count, voice.gain);
+
+        voice.cursor += count;
+        if (voice.cursor >= buffer.frames) {
+            voice.buffer = nullptr;
+            doneSerial[i].store(voice.serial, std::memory_order_release);
+        }
+    }
+
+    // Music is decoded ahead by MusicLoop(); an empty ring just means a moment of silence
+    if (musicPlaying.load(std::memory_order_acquire)) {
+        const float gain = musicGain.load(std::memory_order_relaxed);
+        uint32_t done = 0;
+        while (done < frames) {
+            ma_uint32 available = frames - done;
+            void* ring = nullptr;
+            if (ma_pcm_rb_acquire_read(&musicRing->rb, &available, &ring) != MA_SUCCESS || available == 0) break;
+            MixStereo(out + static_cast<size_t>(done) * 2, static_cast<const float*>(ring), available, gain);
+            ma_pcm_rb_commit_read(&musicRing->rb, available);
+            done += available;
+        }
+    }
+
+    epoch.fetch_add(1, std::memory_order_release);
+}
+
+bool MixerBackend::PlayMusic(const char* filepath, float gain) {
+    if (!deviceStarted || musicPlaying) return false;
+
+    if (!musicFile.Open(filepath)) {
+        std::cerr << "Failed to open music file: " << filepath << std::endl;
+        return false;
+    }
+
+    // The decoder converts to the device's rate and layout as it goes
+    musicDecoder.reset(new ma_decoder);
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 2, sampleRate);
+    if (ma_decoder_init_memory(musicFile.Data(), musicFile.Size(), &config, musicDecoder.get()) != MA_SUCCESS) {
+        std::cerr << "Failed to decode music file: " << filepath << std::endl;
+        musicDecoder.reset();
+        musicFile.Close();
+        return false;
+    }
+
+    // Half a second decoded ahead
+    musicRing.reset(new MusicRing);
+    if (ma_pcm_rb_init(ma_format_f32, 2, sampleRate / 2, NULL, NULL, &musicRing->rb) != MA_SUCCESS) {
+        std::cerr << "Failed to allocate music ring buffer" << std::endl;
+        musicRing.reset();
+        ma_decoder_uninit(musicDecoder.get());
+        musicDecoder.reset();
+        musicFile.Close();
+        return false;
+    }
+
+    RefillMusic();
+    musicGain = gain;
+    musicPlaying = true;
+    musicWorker = std::thread(&MixerBackend::MusicLoop, this);
+    return true;
+}
+
+void MixerBackend::StopMusic() {
+    musicPlaying = false;
+    if (musicWorker.joinable()) musicWorker.join();
+    if (!musicRing) return;
+
+    // The callback may still be reading the ring it saw before the flag flipped
+    WaitForCallbacks(2);
+    ma_pcm_rb_uninit(&musicRing->rb);
+    musicRing.reset();
+    ma_decoder_uninit(musicDecoder.get());
+    musicDecoder.reset();
+    musicFile.Close();
+}
+
+void MixerBackend::RefillMusic() {
+    bool rewound = false;
+    while (true) {
+        ma_uint32 frames = ma_pcm_rb_available_write(&musicRing->rb);
+        if (frames == 0) return;
+
+        void* ring = nullptr;
+        if (ma_pcm_rb_acquire_write(&musicRing->rb, &frames, &ring) != MA_SUCCESS || frames == 0) return;
+
+        ma_uint64 read = 0;
+        ma_decoder_read_pcm_frames(musicDecoder.get(), ring, frames, &read);
+        ma_pcm_rb_commit_write(&musicRing->rb, static_cast<ma_uint32>(read));
+
+        if (read < frames) {
+            // End of track: loop, unless the track is empty
+            if (rewound && read == 0) {
+                std::cerr << "Failed to loop music stream" << std::endl;
+                return;
+            }
+            ma_decoder_seek_to_pcm_frame(musicDecoder.get(), 0);
+            rewound = true;
+        }
+        else {
+            rewound = false;
+        }
+    }
+}
+
+void MixerBackend::MusicLoop() {
+    while (musicPlaying) {
+        RefillMusic();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>                     // State shared with the device callback
+#include <cstdint>                    // uint32_t play serials
+#include <memory>                     // Buffers and miniaudio state kept out of the header
+#include <mutex>                      // Guards the buffer table
+#include <thread>                     // Music refill thread
+#include <vector>                     // Voices and buffers
+
+#include "AudioBackend.h"            // Interface
+#include "MappedFile.h"              // Music file mapping
+#include "SpscQueue.h"               // Voice commands into the callback
+
+struct ma_device;
+struct ma_decoder;
+
+// Mixes every voice itself in a miniaudio device callback, so the only
+// latency between a click and the sound is the callback period. Buffers
+// are converted to float at the device rate when they're created, so the
+// callback does nothing but add samples (see MixKernels.h). Voice commands
+// reach the callback through a lock-free queue and it never locks or
+// allocates. Music is decoded ahead on its own thread into a ring buffer.
+class MixerBackend : public AudioBackend {
+public:
+    MixerBackend();
+    ~MixerBackend() override;
+
+    const char* Name() const override { return "mixer"; }
+    bool Init(const AudioBackendConfig& config) override;
+    void Shutdown() override;
+
+    ALuint CreateBuffer(ALenum format, const void* data, size_t size, unsigned sampleRate,
+        const char* name, bool dataOutlivesBuffer) override;
+    void DeleteBuffer(ALuint buffer) override;
+    bool PlaysInPlace() const override { return false; }
+
+    int VoiceCount() const override { return static_cast<int>(voices.size()); }
+    void StartVoice(int voice, ALuint buffer, float gain) override;
+    void StopVoice(int voice) override;
+    void SetVoiceGain(int voice, float gain) override;
+    bool VoicePlaying(int voice) const override;
+    // The callback that first mixed the voice, plus the device's buffered periods
+    bool VoiceHeardAt(int voice, double& time) const override;
+
+    bool PlayMusic(const char* filepath, float gain) override;
+    void StopMusic() override;
+
+    unsigned SampleRate() const { return sampleRate; }
+
+    // Fills `frames` of interleaved stereo; the device callback's body
+    void Mix(float* out, uint32_t frames);
+
+private:
+    struct MixBuffer {
+        unsigned channels = 0;        // 1 or 2
+        size_t frames = 0;
+        std::vector<float> samples;   // At the device rate
+    };
+
+    struct VoiceCommand {
+        enum class Type { Start, Stop, Gain } type = Type::Stop;
+        int voice = 0;
+        const MixBuffer* buffer = nullptr;
+        float gain = 1.0f;
+        uint32_t serial = 0;
+    };
+
+    // Callback-only state
+    struct Voice {
+        const MixBuffer* buffer = nullptr;
+        size_t cursor = 0;
+        float gain = 1.0f;
+        uint32_t serial = 0;
+    };
+
+    struct MusicRing;                 // Wraps ma_pcm_rb, which can't be forward-declared
+
+    // Deleted buffers wait until the callback has moved past them
+    struct Retired {
+        std::unique_ptr<MixBuffer> buffer;
+        uint64_t epoch = 0;
+    };
+
+    void PostVoice(const VoiceCommand& command);
+    void FreeRetired(bool all);
+    void WaitForCallbacks(uint64_t count);
+    void RefillMusic();
+    void MusicLoop();
+
+    unsigned sampleRate = 0;
+    std::unique_ptr<ma_device> device;
+    bool deviceStarted = false;
+
+    std::mutex bufferMutex;           // Main and audio threads, never the callback
+    std::vector<std::unique_ptr<MixBuffer>> buffers;  // Id - 1
+    std::vector<Retired> retired;
+
+    std::vector<Voice> voices;
+    std::vector<uint32_t> startedSerial;                 // Audio thread
+    std::unique_ptr<std::atomic<uint32_t>[]> doneSerial; // Written by the callback
+    std::unique_ptr<std::atomic<uint32_t>[]> mixedSerial; // Written by the callback...
+    std::unique_ptr<std::atomic<double>[]> mixedHeardAt;  // ...after this
+    double outputLatency = 0.0;                          // Seconds queued ahead of the speaker
+    SpscQueue<VoiceCommand, 512> voiceCommands;
+    std::atomic<uint64_t> epoch{ 0 };                    // Callbacks completed
+
+    MappedFile musicFile;
+    std::unique_ptr<ma_decoder> musicDecoder;
+    std::unique_ptr<MusicRing> musicRing;
+    std::atomic<float> musicGain{ 0.0f };
+    std::atomic<bool> musicPlaying{ false };
+    std::thread musicWorker;
+};
@@ -0,0 +1,192 @@
+#include "MusicStream.h"
+
+#include <chrono>                     // Sleep interval for the refill thread
+#include <cstring>                    // memcpy
+#include <iostream>                   // Error reporting
+
+#include "AudioBackend.h"            // PcmFormat
+#include "WavFile.h"                 // RIFF chunk walk
+
+MusicStream::~MusicStream() {
+    Stop();
+}
+
+bool MusicStream::Open(const char* filepath) {
+    // Nothing of an earlier track may outlive its mapping: a decoder left
+    // open would keep reading it even for a WAV opened next
+    Stop();
+    decoder.Close();
+    file.Close();
+    samples = nullptr;
+    dataSize = 0;
+    position = 0;
+    bufferBytes = 0;
+    format = 0;
+    sampleRate = 0;
+    seam.clear();
+
+    if (!file.Open(filepath)) {
+        std::cerr << "Failed to open music file: " << filepath << std::endl;
+        return false;
+    }
+
+    if (IsCompressedAudio(filepath)) {
+        if (!decoder.Open(file.Data(), file.Size(), filepath)) {
+            file.Close();
+            return false;
+        }
+        format = PcmFormat(decoder.Channels(), 16);
+        sampleRate = decoder.SampleRate();
+        const size_t frameBytes = decoder.Channels() * sizeof(int16_t);
+        bufferBytes = BUFFER_BYTES - BUFFER_BYTES % frameBytes;
+        seam.resize(bufferBytes);
+        return true;
+    }
+
+    WavInfo wav;
+    if (!ParseWavChunks(file.Data(), file.Size(), wav, filepath) || wav.dataSize == 0 || wav.blockAlign == 0) {
+        std::cerr << "WAV file has no usable fmt/data chunk: " << filepath << std::endl;
+        file.Close();
+        return false;
+    }
+
+    format = PcmFormat(wav.channels, wav.bitsPerSample);
+    if (!format) {
+        std::cerr << "Unsupported music format: " << filepath << std::endl;
+        file.Close();
+        return false;
+    }
+
+    // Keep every refill on a whole-frame boundary
+    samples = wav.data;
+    dataSize = wav.dataSize;
+    sampleRate = wav.sampleRate;
+    position = 0;
+    bufferBytes = BUFFER_BYTES - BUFFER_BYTES % wav.blockAlign;
+    return true;
+}
+
+bool MusicStream::FillBuffer(ALuint buffer) {
+    if (decoder.IsOpen()) return FillFromDecoder(buffer);
+
+    const unsigned char* data = samples + position;
+    if (position + bufferBytes <= dataSize) {
+        // Common case: hand OpenAL the mapped samples directly
+        position += bufferBytes;
+        if (position == dataSize) position = 0;
+    }
+    else {
+        // Loop: stitch the end of the track to its start so the next buffer continues seamlessly
+        seam.resize(bufferBytes);
+        size_t filled = 0;
+        while (filled < bufferBytes) {
+            size_t want = bufferBytes - filled;
+            if (want > dataSize - position) want = dataSize - position;
+            memcpy(seam.data() + filled, samples + position, want);
+            filled += want;
+            position += want;
+            if (position == dataSize) position = 0;
+        }
+        data = seam.data();
+    }
+
+    alBufferData(buffer, format, data, static_cast<ALsizei>(bufferBytes), sampleRate);
+    return BufferFilled(buffer);
+}
+
+// alGetError() would also see (and clear) errors from the threads uploading
+// sounds, so the upload is checked by what the buffer now holds
+bool MusicStream::BufferFilled(ALuint buffer) const {
+    ALint stored = 0;
+    alGetBufferi(buffer, AL_SIZE, &stored);
+    return stored == static_cast<ALint>(bufferBytes);
+}
+
+bool MusicStream::FillFromDecoder(ALuint buffer) {
+    int16_t* out = reinterpret_cast<int16_t*>(seam.data());
+    const size_t channels = decoder.Channels();
+    const size_t frames = bufferBytes / (channels * sizeof(int16_t));
+
+    size_t filled = 0;
+    bool rewound = false;
+    while (filled < frames) {
+        const size_t got = decoder.Read(out + filled * channels, frames - filled);
+        if (got == 0) {
+            // End of track: start over so the buffer continues seamlessly, unless it's empty
+            if (rewound || !decoder.Rewind()) {
+                std::cerr << "Failed to loop music stream" << std::endl;
+                return false;
+            }
+            rewound = true;
+            continue;
+        }
+        rewound = false;
+        filled += got;
+    }
+
+    alBufferData(buffer, format, seam.data(), static_cast<ALsizei>(bufferBytes), sampleRate);
+    return BufferFilled(buffer);
+}
+
+void MusicStream::Play(ALuint musicSource, float gain) {
+    if (!IsOpen() || running || !musicSource) return;
+
+    source = musicSource;
+    alGenBuffers(NUM_BUFFERS, buffers);
+    for (ALuint buffer : buffers) {
+        if (!FillBuffer(buffer)) {
+            std::cerr << "Failed to prime music stream" << std::endl;
+            Stop();
+            return;
+        }
+    }
+
+    alSourceQueueBuffers(source, NUM_BUFFERS, buffers);
+    alSourcef(source, AL_GAIN, gain);
+    alSourcePlay(source);
+
+    running = true;
+    worker = std::thread(&MusicStream::StreamLoop, this);
+}
+
+void MusicStream::StreamLoop() {
+    while (running) {
+        ALint processed = 0;
+        alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+        while (processed-- > 0) {
+            ALuint buffer;
+            alSourceUnqueueBuffers(source, 1, &buffer);
+            if (FillBuffer(buffer)) {
+                alSourceQueueBuffers(source, 1, &buffer);
+            }
+        }
+
+        // If we fell behind and the queue drained, the source stops by itself
+        ALint state;
+        alGetSourcei(source, AL_SOURCE_STATE, &state);
+        if (state != AL_PLAYING) {
+            ALint queued = 0;
+            alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+            if (queued > 0) alSourcePlay(source);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+void MusicStream::Stop() {
+    running = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+
+    if (source) {
+        alSourceStop(source);
+        alSourcei(source, AL_BUFFER, 0);  // Detaches all queued buffers
+        source = 0;
+    }
+    if (buffers[0]) {
+        alDeleteBuffers(NUM_BUFFERS, buffers);
+        for (ALuint& buffer : buffers) buffer = 0;
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>                     // std::atomic flag shared with the worker
+#include <cstddef>                    // size_t
+#include <cstdint>                    // int16_t decoded samples
+#include <thread>                     // Background refill thread
+#include <vector>                     // Staging buffer for the loop seam
+
+#include <AL/al.h>                    // OpenAL sources and buffers
+
+#include "AudioDecoder.h"            // MP3/FLAC tracks
+#include "MappedFile.h"              // The file is mapped, not read
+
+// Plays a long PCM WAV file through a small ring of queued OpenAL buffers
+// instead of one buffer holding the whole file. A background thread refills
+// the buffers OpenAL has finished with straight from the memory-mapped file,
+// and wraps back to the start of the data chunk, so the track loops without
+// a gap. Only the one buffer that straddles the loop point is copied.
+// MP3 and FLAC tracks are decoded a buffer at a time on the same thread. The source is borrowed from
+// the caller (the OpenAL backend's dedicated music source) and handed back on Stop().
+class MusicStream {
+public:
+    static const int NUM_BUFFERS = 4;
+    static const size_t BUFFER_BYTES = 64 * 1024; // ~0.37 s of 44.1 kHz 16-bit stereo
+
+    ~MusicStream();
+
+    // Stops and closes any track already open first
+    bool Open(const char* filepath);
+    void Play(ALuint musicSource, float gain);
+    void Stop();
+
+    bool IsOpen() const { return format != 0; }
+    ALuint Source() const { return source; }
+
+private:
+    bool FillBuffer(ALuint buffer);
+    void StreamLoop();
+
+    bool FillFromDecoder(ALuint buffer);
+    bool BufferFilled(ALuint buffer) const;
+
+    MappedFile file;
+    AudioStreamDecoder decoder;       // Open only for compressed tracks
+    const unsigned char* samples = nullptr;
+    size_t dataSize = 0;
+    size_t position = 0;              // Next byte of the data chunk to queue
+    size_t bufferBytes = 0;           // BUFFER_BYTES rounded down to whole frames
+    ALenum format = 0;
+    unsigned sampleRate = 0;
+
+    ALuint source = 0;
+    ALuint buffers[NUM_BUFFERS] = {};
+    std::vector<unsigned char> seam;  // Loop seam, or the decoder's output
+
+    std::thread worker;
+    std::atomic<bool> running{ false };
+};
@@ -0,0 +1,37 @@
+#include "NullAudioBackend.h"
+
+bool NullAudioBackend::Init(const AudioBackendConfig& config) {
+    remaining.assign(config.voices > 0 ? config.voices : 1, 0.0);
+    return true;
+}
+
+void NullAudioBackend::Shutdown() {
+    remaining.clear();
+    durations.clear();
+}
+
+ALuint NullAudioBackend::CreateBuffer(ALenum format, const void*, size_t size, unsigned sampleRate,
+    const char*, bool) {
+    unsigned frameBytes = 0;
+    switch (format) {
+    case AL_FORMAT_MONO8:    frameBytes = 1; break;
+    case AL_FORMAT_MONO16:   frameBytes = 2; break;
+    case AL_FORMAT_STEREO8:  frameBytes = 2; break;
+    case AL_FORMAT_STEREO16: frameBytes = 4; break;
+    default: return 0;
+    }
+    if (sampleRate == 0) return 0;
+
+    durations.push_back(static_cast<double>(size / frameBytes) / sampleRate);
+    return static_cast<ALuint>(durations.size());
+}
+
+void NullAudioBackend::StartVoice(int voice, ALuint buffer, float) {
+    remaining[voice] = (buffer > 0 && buffer <= durations.size()) ? durations[buffer - 1] : 0.0;
+}
+
+void NullAudioBackend::Advance(double seconds) {
+    for (double& left : remaining) {
+        left = (left > seconds) ? left - seconds : 0.0;
+    }
+}
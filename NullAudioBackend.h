@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>                     // Buffer lengths and voice timers
+
+#include "AudioBackend.h"            // Interface
+
+// Plays nothing, but keeps time: each buffer remembers how long its sound
+// is, and a voice counts as playing until Advance() has moved that far past
+// its start. Lets the headless build run the game logic, sound buttons
+// included, on machines without a sound card and with the same results
+// every run.
+class NullAudioBackend : public AudioBackend {
+public:
+    const char* Name() const override { return "null"; }
+    bool Init(const AudioBackendConfig& config) override;
+    void Shutdown() override;
+
+    ALuint CreateBuffer(ALenum format, const void* data, size_t size, unsigned sampleRate,
+        const char* name, bool dataOutlivesBuffer) override;
+    void DeleteBuffer(ALuint) override {}
+    bool PlaysInPlace() const override { return false; }
+
+    int VoiceCount() const override { return static_cast<int>(remaining.size()); }
+    void StartVoice(int voice, ALuint buffer, float gain) override;
+    void StopVoice(int voice) override { remaining[voice] = 0.0; }
+    void SetVoiceGain(int, float) override {}
+    bool VoicePlaying(int voice) const override { return remaining[voice] > 0.0; }
+
+    bool PlayMusic(const char*, float) override { return true; }
+    void StopMusic() override {}
+
+    // Moves every playing voice on by this much simulated time
+    void Advance(double seconds);
+
+private:
+    std::vector<double> durations;    // Seconds, by buffer id - 1
+    std::vector<double> remaining;    // Seconds left, by voice
+};
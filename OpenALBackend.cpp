@@ -0,0 +1,210 @@
+#include "OpenALBackend.h"
+
+#include <cstdint>                    // int64_t device latency
+#include <iostream>                   // Error reporting
+
+#include "LatencyTracker.h"          // LatencyNow() for heard times
+
+namespace {
+
+// AL_EXT_STATIC_BUFFER entry point; spelled out here because alext.h pulls
+// in efx.h, which isn't among the bundled OpenAL headers
+typedef void (AL_APIENTRY* BufferDataStaticProc)(const ALuint, ALenum, ALvoid*, ALsizei, ALsizei);
+
+BufferDataStaticProc BufferDataStatic() {
+    // Looked up on first use, once the AL context is current
+    static const BufferDataStaticProc proc = alIsExtensionPresent("AL_EXT_STATIC_BUFFER")
+        ? reinterpret_cast<BufferDataStaticProc>(alGetProcAddress("alBufferDataStatic")) : nullptr;
+    return proc;
+}
+
+// AL_SOFT_source_latency and ALC_SOFT_device_clock, spelled out for the same reason
+const ALenum SEC_OFFSET_LATENCY_SOFT = 0x1201;
+const ALCenum DEVICE_LATENCY_SOFT = 0x1601;
+typedef void (AL_APIENTRY* GetSourcedvProc)(ALuint, ALenum, ALdouble*);
+typedef void (ALC_APIENTRY* GetInteger64vProc)(ALCdevice*, ALCenum, ALsizei, int64_t*);
+
+GetSourcedvProc GetSourcedv() {
+    static const GetSourcedvProc proc = alIsExtensionPresent("AL_SOFT_source_latency")
+        ? reinterpret_cast<GetSourcedvProc>(alGetProcAddress("alGetSourcedvSOFT")) : nullptr;
+    return proc;
+}
+
+GetInteger64vProc GetInteger64v(ALCdevice* device) {
+    static const GetInteger64vProc proc = alcIsExtensionPresent(device, "ALC_SOFT_device_clock")
+        ? reinterpret_cast<GetInteger64vProc>(alcGetProcAddress(device, "alcGetInteger64vSOFT")) : nullptr;
+    return proc;
+}
+
+} // namespace
+
+OpenALBackend::~OpenALBackend() {
+    Shutdown();
+}
+
+bool OpenALBackend::Init(const AudioBackendConfig& config) {
+    device = alcOpenDevice(NULL);
+    if (!device) {
+        std::cerr << "Failed to open OpenAL device" << std::endl;
+        return false;
+    }
+
+    context = alcCreateContext(device, NULL);
+    if (!alcMakeContextCurrent(context)) {
+        std::cerr << "Failed to make OpenAL context current" << std::endl;
+        Shutdown();
+        return false;
+    }
+
+    // Set listener properties
+    alListener3f(AL_POSITION, 0.0f, 0.0f, 0.0f);
+    alListener3f(AL_VELOCITY, 0.0f, 0.0f, 0.0f);
+    ALfloat listenerOri[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f };
+    alListenerfv(AL_ORIENTATION, listenerOri);
+
+    // The context's error state is shared by every thread making AL calls
+    // (the music stream, buffer uploads), so calls are checked by their
+    // results rather than alGetError(), which another thread may have cleared
+    musicSource = 0;
+    alGenSources(1, &musicSource);
+    if (!alIsSource(musicSource)) musicSource = 0;
+
+    for (int i = 0; i < config.voices; ++i) {
+        ALuint source = 0;
+        alGenSources(1, &source);
+        if (!alIsSource(source)) {
+            // Some drivers have a hard source limit; run with what we got
+            std::cerr << "OpenAL source pool limited to " << i << " voices" << std::endl;
+            break;
+        }
+        sources.push_back(source);
+    }
+    if (sources.empty()) {
+        std::cerr << "Failed to create OpenAL sources" << std::endl;
+        Shutdown();
+        return false;
+    }
+    return true;
+}
+
+void OpenALBackend::Shutdown() {
+    StopMusic();
+    for (ALuint& source : sources) {
+        alSourceStop(source);
+        alDeleteSources(1, &source);
+    }
+    sources.clear();
+    if (musicSource) {
+        alDeleteSources(1, &musicSource);
+        musicSource = 0;
+    }
+
+    if (context) {
+        alcMakeContextCurrent(NULL);
+        alcDestroyContext(context);
+        context = nullptr;
+    }
+    if (device) {
+        alcCloseDevice(device);
+        device = nullptr;
+    }
+}
+
+ALuint OpenALBackend::CreateBuffer(ALenum format, const void* data, size_t size, unsigned sampleRate,
+    const char* name, bool dataOutlivesBuffer) {
+    // Create OpenAL buffer
+    ALuint buffer = 0;
+    alGenBuffers(1, &buffer);
+    if (!alIsBuffer(buffer)) {
+        std::cerr << "OpenAL couldn't create a buffer for: " << name << std::endl;
+        return 0;
+    }
+
+    BufferDataStaticProc bufferDataStatic = dataOutlivesBuffer ? BufferDataStatic() : nullptr;
+    if (bufferDataStatic) {
+        // The mapping is read-only; OpenAL never writes through this pointer
+        bufferDataStatic(buffer, format, const_cast<void*>(data), static_cast<ALsizei>(size), sampleRate);
+    }
+    else {
+        alBufferData(buffer, format, data, static_cast<ALsizei>(size), sampleRate);
+    }
+
+    // A rejected upload (bad format or rate, out of memory) leaves the buffer empty
+    ALint stored = 0;
+    alGetBufferi(buffer, AL_SIZE, &stored);
+    if (stored != static_cast<ALint>(size)) {
+        std::cerr << "OpenAL rejected the samples of: " << name << std::endl;
+        alDeleteBuffers(1, &buffer);
+        return 0;
+    }
+
+    return buffer;
+}
+
+void OpenALBackend::DeleteBuffer(ALuint buffer) {
+    if (buffer) alDeleteBuffers(1, &buffer);
+}
+
+bool OpenALBackend::PlaysInPlace() const {
+    return BufferDataStatic() != nullptr;
+}
+
+void OpenALBackend::StartVoice(int voice, ALuint buffer, float gain) {
+    const ALuint source = sources[voice];
+    alSourceStop(source);
+    alSourcei(source, AL_BUFFER, buffer);
+    alSourcei(source, AL_LOOPING, AL_FALSE);
+    alSourcef(source, AL_GAIN, gain);
+    alSourcePlay(source);
+}
+
+void OpenALBackend::StopVoice(int voice) {
+    alSourceStop(sources[voice]);
+    alSourcei(sources[voice], AL_BUFFER, 0);
+}
+
+void OpenALBackend::SetVoiceGain(int voice, float gain) {
+    alSourcef(sources[voice], AL_GAIN, gain);
+}
+
+bool OpenALBackend::VoicePlaying(int voice) const {
+    ALint state;
+    alGetSourcei(sources[voice], AL_SOURCE_STATE, &state);
+    return state == AL_PLAYING || state == AL_PAUSED;
+}
+
+// Where the source is now, minus how far it has played, plus what the
+// device still has queued ahead of the speaker
+bool OpenALBackend::VoiceHeardAt(int voice, double& time) const {
+    const ALuint source = sources[voice];
+    ALint state;
+    alGetSourcei(source, AL_SOURCE_STATE, &state);
+    if (state != AL_PLAYING) return false;  // Offsets of a finished source say nothing
+
+    const double now = LatencyNow();
+    if (GetSourcedvProc getSourcedv = GetSourcedv()) {
+        ALdouble offsetLatency[2] = {};
+        getSourcedv(source, SEC_OFFSET_LATENCY_SOFT, offsetLatency);
+        time = now - offsetLatency[0] + offsetLatency[1];
+        return true;
+    }
+    if (GetInteger64vProc getInteger64v = GetInteger64v(device)) {
+        int64_t latencyNs = 0;
+        getInteger64v(device, DEVICE_LATENCY_SOFT, 1, &latencyNs);
+        ALfloat offset = 0.0f;
+        alGetSourcef(source, AL_SEC_OFFSET, &offset);
+        time = now - offset + latencyNs * 1.0e-9;
+        return true;
+    }
+    return false;
+}
+
+bool OpenALBackend::PlayMusic(const char* filepath, float gain) {
+    if (!musicSource || !music.Open(filepath)) return false;
+    music.Play(musicSource, gain);
+    return true;
+}
+
+void OpenALBackend::StopMusic() {
+    music.Stop();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>                     // Voice sources
+
+#include <AL/al.h>                    // OpenAL sources and buffers
+#include <AL/alc.h>                   // Device and context
+
+#include "AudioBackend.h"            // Interface
+#include "MusicStream.h"             // Queued-buffer music
+
+// One OpenAL source per voice; mixing and resampling are left to the
+// platform's OpenAL. Buffers are OpenAL buffer names, filled in place with
+// AL_EXT_STATIC_BUFFER where the driver has it.
+class OpenALBackend : public AudioBackend {
+public:
+    ~OpenALBackend() override;
+
+    const char* Name() const override { return "openal"; }
+    bool Init(const AudioBackendConfig& config) override;
+    void Shutdown() override;
+
+    ALuint CreateBuffer(ALenum format, const void* data, size_t size, unsigned sampleRate,
+        const char* name, bool dataOutlivesBuffer) override;
+    void DeleteBuffer(ALuint buffer) override;
+    bool PlaysInPlace() const override;
+
+    int VoiceCount() const override { return static_cast<int>(sources.size()); }
+    void StartVoice(int voice, ALuint buffer, float gain) override;
+    void StopVoice(int voice) override;
+    void SetVoiceGain(int voice, float gain) override;
+    bool VoicePlaying(int voice) const override;
+    // From AL_SOFT_source_latency, or ALC_SOFT_device_clock's device latency
+    // plus the source offset; false on drivers with neither
+    bool VoiceHeardAt(int voice, double& time) const override;
+
+    bool PlayMusic(const char* filepath, float gain) override;
+    void StopMusic() override;
+
+private:
+    ALCdevice* device = nullptr;
+    ALCcontext* context = nullptr;
+    std::vector<ALuint> sources;
+    ALuint musicSource = 0;
+    MusicStream music;
+};
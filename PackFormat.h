@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <cstdint>                    // Fixed-width on-disk fields
+
+// On-disk layout of assets.pak, written by AssetCooker and mapped by
+// AssetPack. All fields are little-endian. The file is a PackHeader, then
+// entryCount PackEntry records, then the blobs, each aligned to PACK_ALIGNMENT.
+// Texture blobs hold every mip level back to back, largest first.
+const char PACK_MAGIC[4] = { 'M', 'W', 'P', 'K' };
+const uint32_t PACK_VERSION = 1;
+const size_t PACK_ALIGNMENT = 16;
+const size_t PACK_NAME_LENGTH = 64;
+
+enum class PackType : uint32_t {
+    Texture = 0,                      // Mipmapped, drawn on its own
+    Sprite = 1,                       // Single level RGBA8, packed into the atlas at runtime
+    Sound = 2,                        // Raw PCM samples
+};
+
+enum class PackFormat : uint32_t {
+    None = 0,                         // Sounds
+    RGBA8 = 1,
+    BC1 = 2,                          // Opaque, 8 bytes per 4x4 block
+    BC3 = 3,                          // With alpha, 16 bytes per 4x4 block
+};
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct PackEntry {
+    char name[PACK_NAME_LENGTH];      // Original asset path, e.g. "assets/cat.png"
+    PackType type;
+    PackFormat format;
+    uint32_t width;                   // Textures: size of level 0
+    uint32_t height;
+    uint32_t levels;
+    uint32_t channels;                // Sounds
+    uint32_t bitsPerSample;
+    uint32_t sampleRate;
+    uint64_t offset;                  // From the start of the file
+    uint64_t size;
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout changed");
+static_assert(sizeof(PackEntry) == 112, "PackEntry layout changed");
+
+// Bytes used by one mip level
+inline size_t PackLevelSize(PackFormat format, uint32_t width, uint32_t height) {
+    const size_t blocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+    switch (format) {
+    case PackFormat::RGBA8: return static_cast<size_t>(width) * height * 4;
+    case PackFormat::BC1: return blocks * 8;
+    case PackFormat::BC3: return blocks * 16;
+    default: return 0;
+    }
+}
+
+inline uint32_t PackLevelDimension(uint32_t size, uint32_t level) {
+    const uint32_t scaled = size >> level;
+    return scaled ? scaled : 1;
+}
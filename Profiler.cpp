@@ -0,0 +1,243 @@
+#include "Profiler.h"
+
+#include <algorithm>                  // std::max
+#include <cstdio>                     // snprintf for overlay lines
+#include <iostream>                   // Error reporting
+
+#include "SpriteBatch.h"             // Overlay background
+#include "TextRenderer.h"            // Overlay text
+
+namespace {
+
+double ElapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+bool Profiler::Init() {
+    // Timestamp queries are core in GL 3.3; older drivers still get CPU timings
+    gpuTimers = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!gpuTimers) {
+        std::cerr << "GL timer queries not supported; profiling CPU only" << std::endl;
+    }
+    return true;
+}
+
+void Profiler::Release() {
+    StopCapture();
+    for (auto& section : sections) {
+        if (section.queries[0][0]) {
+            glDeleteQueries(QUERY_FRAMES * 2, &section.queries[0][0]);
+        }
+    }
+    sections.clear();
+    counters.clear();
+}
+
+int Profiler::AddSection(const char* name, bool gpu) {
+    Section section;
+    section.name = name;
+    section.gpu = gpu && gpuTimers;
+    if (section.gpu) {
+        glGenQueries(QUERY_FRAMES * 2, &section.queries[0][0]);
+    }
+    sections.push_back(section);
+    return static_cast<int>(sections.size()) - 1;
+}
+
+int Profiler::AddCounter(const char* name) {
+    Counter counter;
+    counter.name = name;
+    counters.push_back(counter);
+    return static_cast<int>(counters.size()) - 1;
+}
+
+void Profiler::BeginFrame() {
+    inFrame = Enabled();
+    if (!inFrame) {
+        haveFrameStart = false;  // Don't count the time spent disabled
+        return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    frameMs = haveFrameStart ? ElapsedMs(frameStart, now) : 0.0;
+    frameStart = now;
+    haveFrameStart = true;
+    queryFrame = static_cast<int>(frameNumber % QUERY_FRAMES);
+
+    // The slot we're about to reuse was issued QUERY_FRAMES ago; its results
+    // are almost certainly in by now
+    for (auto& section : sections) {
+        section.cpuMs = 0.0;
+        if (section.gpu) CollectGpu(section);
+    }
+}
+
+void Profiler::EndFrame() {
+    if (!inFrame) return;
+    inFrame = false;
+
+    frameSum += frameMs;
+    for (auto& section : sections) {
+        section.cpuSum += section.cpuMs;
+        if (section.gpuMs >= 0.0) {
+            section.gpuSum += section.gpuMs;
+            ++section.gpuSamples;
+        }
+    }
+
+    if (csv.is_open()) WriteCsvRow();
+
+    ++frameNumber;
+    if (++framesSummed >= AVERAGE_FRAMES) {
+        RefreshOverlay();
+        frameSum = 0.0;
+        framesSummed = 0;
+        for (auto& section : sections) {
+            section.cpuSum = 0.0;
+            section.gpuSum = 0.0;
+            section.gpuSamples = 0;
+        }
+    }
+}
+
+void Profiler::BeginSection(int section) {
+    if (!inFrame) return;
+
+    Section& s = sections[section];
+    s.start = Clock::now();
+    if (s.gpu) glQueryCounter(s.queries[queryFrame][0], GL_TIMESTAMP);
+}
+
+void Profiler::EndSection(int section) {
+    if (!inFrame) return;
+
+    Section& s = sections[section];
+    s.cpuMs += ElapsedMs(s.start, Clock::now());
+    if (s.gpu) {
+        glQueryCounter(s.queries[queryFrame][1], GL_TIMESTAMP);
+        s.issued[queryFrame] = true;
+    }
+}
+
+void Profiler::SetCounter(int counter, int value) {
+    counters[counter].value = value;
+}
+
+void Profiler::CollectGpu(Section& section) {
+    section.gpuMs = -1.0;
+    if (!section.issued[queryFrame]) return;
+    section.issued[queryFrame] = false;
+
+    GLuint* pair = section.queries[queryFrame];
+    GLint available = 0;
+    glGetQueryObjectiv(pair[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;  // Drop the sample rather than stall
+
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(pair[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(pair[1], GL_QUERY_RESULT, &end);
+    section.gpuMs = static_cast<double>(end - begin) / 1.0e6;
+}
+
+bool Profiler::StartCapture(const char* filepath) {
+    StopCapture();
+    csv.open(filepath, std::ios::out | std::ios::trunc);
+    if (!csv) {
+        std::cerr << "Failed to open profile capture: " << filepath << std::endl;
+        return false;
+    }
+    WriteCsvHeader();
+    std::cout << "Profiling to " << filepath << std::endl;
+    return true;
+}
+
+void Profiler::StopCapture() {
+    if (csv.is_open()) csv.close();
+}
+
+void Profiler::WriteCsvHeader() {
+    csv << "frame,frame_ms";
+    for (const auto& section : sections) {
+        csv << ',' << section.name << "_cpu_ms";
+        if (section.gpu) csv << ',' << section.name << "_gpu_ms";
+    }
+    for (const auto& counter : counters) {
+        csv << ',' << counter.name;
+    }
+    csv << '\n';
+}
+
+// GPU columns hold the result that came back this frame, which belongs to
+// the frame QUERY_FRAMES - 1 rows earlier; empty when it wasn't ready
+void Profiler::WriteCsvRow() {
+    csv << frameNumber << ',' << frameMs;
+    for (const auto& section : sections) {
+        csv << ',' << section.cpuMs;
+        if (section.gpu) {
+            csv << ',';
+            if (section.gpuMs >= 0.0) csv << section.gpuMs;
+        }
+    }
+    for (const auto& counter : counters) {
+        csv << ',' << counter.value;
+    }
+    csv << '\n';
+}
+
+void Profiler::RefreshOverlay() {
+    char line[96];
+    overlayLines.resize(1 + sections.size() + counters.size());
+
+    const double frameAvg = frameSum / framesSummed;
+    std::snprintf(line, sizeof(line), "FRAME %6.2f MS", frameAvg);
+    overlayLines[0] = line;
+
+    size_t row = 1;
+    for (const auto& section : sections) {
+        const double cpuAvg = section.cpuSum / framesSummed;
+        if (section.gpuSamples > 0) {
+            std::snprintf(line, sizeof(line), "%-8s CPU %6.2f GPU %6.2f", section.name.c_str(),
+                cpuAvg, section.gpuSum / section.gpuSamples);
+        }
+        else {
+            std::snprintf(line, sizeof(line), "%-8s CPU %6.2f", section.name.c_str(), cpuAvg);
+        }
+        overlayLines[row++] = line;
+    }
+    for (const auto& counter : counters) {
+        std::snprintf(line, sizeof(line), "%-14s %5d", counter.name.c_str(), counter.value);
+        overlayLines[row++] = line;
+    }
+}
+
+void Profiler::DrawOverlay(SpriteBatch& batch, const TextRenderer& text, int viewHeight) {
+    if (!overlayVisible || overlayLines.empty() || viewHeight <= 0) return;
+
+    // One text row is 7 font pixels plus a 2-pixel gap, in NDC
+    const float lineHeight = 2.0f * (TextRenderer::GLYPH_ROWS + 2) * TextRenderer::PIXEL_SCALE / viewHeight;
+    const float left = -0.99f;
+    const float top = 0.99f;
+
+    float width = 0.0f;
+    for (const auto& line : overlayLines) {
+        width = std::max(width, text.TextWidth(line));
+    }
+    for (const auto& line : extraLines) {
+        width = std::max(width, text.TextWidth(line));
+    }
+    const float height = lineHeight * (overlayLines.size() + extraLines.size()) + lineHeight * 0.5f;
+
+    batch.DrawRect(left, top - height, width + 0.02f, height, { 0.0f, 0.0f, 0.0f, 0.6f });
+
+    float y = top - lineHeight;
+    for (const auto& line : overlayLines) {
+        text.DrawString(batch, line.c_str(), left + 0.01f, y, { 1.0f, 1.0f, 1.0f, 1.0f });
+        y -= lineHeight;
+    }
+    for (const auto& line : extraLines) {
+        text.DrawString(batch, line.c_str(), left + 0.01f, y, { 1.0f, 1.0f, 1.0f, 1.0f });
+        y -= lineHeight;
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>                     // steady_clock for CPU timings
+#include <fstream>                    // CSV capture
+#include <string>                     // Section names, overlay lines
+#include <vector>                     // Sections, counters
+
+#include <glew.h>                     // GL timer queries
+
+class SpriteBatch;
+class TextRenderer;
+
+// Per-frame timings and counters for the main loop. The frame time is the
+// interval between BeginFrame() calls, so it includes vsync. CPU sections are timed
+// with steady_clock; sections marked gpu also get a pair of GL_TIMESTAMP
+// queries, read back a few frames later so the CPU never waits on the GPU.
+// Results can be shown as an overlay and/or appended to a CSV file, one row
+// per frame. Costs next to nothing while neither is enabled.
+class Profiler {
+public:
+    static const int QUERY_FRAMES = 4;   // Frames in flight before GPU results are read
+    static const int AVERAGE_FRAMES = 30; // Overlay shows the mean over this many frames
+
+    bool Init();                      // Needs a current GL context
+    void Release();
+
+    int AddSection(const char* name, bool gpu);
+    int AddCounter(const char* name);
+
+    void BeginFrame();
+    void EndFrame();
+
+    void BeginSection(int section);
+    void EndSection(int section);
+    void SetCounter(int counter, int value);
+
+    // Enabled while the overlay is visible or a capture is running
+    bool Enabled() const { return overlayVisible || csv.is_open(); }
+
+    void ToggleOverlay() { overlayVisible = !overlayVisible; }
+    bool OverlayVisible() const { return overlayVisible; }
+    void DrawOverlay(SpriteBatch& batch, const TextRenderer& text, int viewHeight);
+    // Shown under the counters as they are, e.g. the audio latency percentiles
+    void SetExtraLines(const std::vector<std::string>& lines) { extraLines = lines; }
+
+    bool StartCapture(const char* filepath);
+    void StopCapture();
+    bool Capturing() const { return csv.is_open(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Section {
+        std::string name;
+        bool gpu = false;
+        Clock::time_point start;
+        double cpuMs = 0.0;
+        double gpuMs = -1.0;          // < 0 while no result is available
+        double cpuSum = 0.0;
+        double gpuSum = 0.0;
+        int gpuSamples = 0;
+        GLuint queries[QUERY_FRAMES][2] = {};
+        bool issued[QUERY_FRAMES] = {};
+    };
+
+    struct Counter {
+        std::string name;
+        int value = 0;
+    };
+
+    void CollectGpu(Section& section);
+    void WriteCsvHeader();
+    void WriteCsvRow();
+    void RefreshOverlay();
+
+    std::vector<Section> sections;
+    std::vector<Counter> counters;
+    bool gpuTimers = false;
+    bool inFrame = false;
+    int queryFrame = 0;
+
+    Clock::time_point frameStart;     // Previous BeginFrame(), for the frame interval
+    bool haveFrameStart = false;
+    double frameMs = 0.0;
+    double frameSum = 0.0;
+    int framesSummed = 0;
+    long long frameNumber = 0;
+
+    bool overlayVisible = false;
+    std::vector<std::string> overlayLines;
+    std::vector<std::string> extraLines;
+
+    std::ofstream csv;
+};
+
+// Times a block of code as one profiler section
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, int section) : profiler(profiler), section(section) {
+        profiler.BeginSection(section);
+    }
+    ~ProfileScope() { profiler.EndSection(section); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& profiler;
+    int section;
+};
@@ -0,0 +1,114 @@
+#include "SourcePool.h"
+
+#include <algorithm>                  // std::min
+
+#include "AudioBackend.h"            // The voices themselves
+
+bool SourcePool::Init(AudioBackend* audioBackend, int size) {
+    backend = audioBackend;
+    voices.clear();
+    if (!backend) return false;
+
+    // The backend already ran into any driver limit when it created its voices
+    voices.resize(std::min(size, backend->VoiceCount()));
+    return !voices.empty();
+}
+
+void SourcePool::Release() {
+    for (int i = 0; i < static_cast<int>(voices.size()); ++i) {
+        backend->StopVoice(i);
+    }
+    voices.clear();
+}
+
+// A voice counts as busy while its sound is still playing. Finished voices
+// become free without any per-frame polling; we only ask when we need one.
+bool SourcePool::IsBusy(int index) const {
+    const Voice& voice = voices[index];
+    if (!voice.inUse) return false;
+    return backend->VoicePlaying(index);
+}
+
+int SourcePool::FindVoice(VoicePriority priority) const {
+    int victim = -1;
+    for (int i = 0; i < static_cast<int>(voices.size()); ++i) {
+        const Voice& voice = voices[i];
+        if (!IsBusy(i)) return i;
+        if (voice.priority > priority) continue;
+
+        // Prefer the lowest priority, then whatever started first
+        if (victim < 0 || voice.priority < voices[victim].priority ||
+            (voice.priority == voices[victim].priority && voice.startedAt < voices[victim].startedAt)) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+VoiceHandle SourcePool::Play(ALuint buffer, VoicePriority priority, float gain) {
+    VoiceHandle handle;
+    if (!buffer) return handle;
+
+    int index = FindVoice(priority);
+    if (index < 0) return handle;
+
+    Voice& voice = voices[index];
+    backend->StartVoice(index, buffer, gain);
+
+    voice.inUse = true;
+    voice.priority = priority;
+    voice.startedAt = ++playCounter;
+    ++voice.generation;
+
+    handle.index = index;
+    handle.generation = voice.generation;
+    return handle;
+}
+
+void SourcePool::Stop(VoiceHandle handle) {
+    if (handle.index < 0 || handle.index >= static_cast<int>(voices.size())) return;
+
+    Voice& voice = voices[handle.index];
+    if (voice.generation != handle.generation) return;
+
+    backend->StopVoice(handle.index);
+    voice.inUse = false;
+}
+
+bool SourcePool::IsPlaying(VoiceHandle handle) const {
+    if (handle.index < 0 || handle.index >= static_cast<int>(voices.size())) return false;
+
+    const Voice& voice = voices[handle.index];
+    return voice.generation == handle.generation && IsBusy(handle.index);
+}
+
+void SourcePool::SetGain(VoiceHandle handle, float gain) {
+    if (handle.index < 0 || handle.index >= static_cast<int>(voices.size())) return;
+
+    const Voice& voice = voices[handle.index];
+    if (voice.generation != handle.generation) return;
+
+    backend->SetVoiceGain(handle.index, gain);
+}
+
+bool SourcePool::HeardAt(VoiceHandle handle, double& time) const {
+    if (handle.index < 0 || handle.index >= static_cast<int>(voices.size())) return false;
+
+    const Voice& voice = voices[handle.index];
+    return voice.generation == handle.generation && backend->VoiceHeardAt(handle.index, time);
+}
+
+void SourcePool::StopAll() {
+    for (int i = 0; i < static_cast<int>(voices.size()); ++i) {
+        backend->StopVoice(i);
+        voices[i].inUse = false;
+    }
+}
+
+int SourcePool::LiveVoices() const {
+    int live = 0;
+    for (int i = 0; i < static_cast<int>(voices.size()); ++i) {
+        if (IsBusy(i)) ++live;
+    }
+    return live;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>                    // uint32_t generations
+#include <vector>                     // Voice table
+
+#include <AL/al.h>                    // ALuint buffer handles
+
+class AudioBackend;
+
+// Higher values win when the pool is full and a voice has to be stolen.
+enum class VoicePriority {
+    Music = 0,
+    Animal = 1,
+    Feedback = 2,
+};
+
+// Refers to one playback on a pooled voice. A handle goes stale as soon as the
+// voice is reused for something else, so holding one is always safe.
+struct VoiceHandle {
+    int index = -1;
+    uint32_t generation = 0;
+};
+
+// Hands out the backend's fixed set of voices, created once at startup.
+// Finished voices are recycled instead of deleted; when every voice is busy,
+// Play() steals the lowest-priority (then oldest) voice that doesn't outrank
+// the new sound. Not thread-safe; the game reaches it through AudioSystem's
+// audio thread.
+class SourcePool {
+public:
+    static const int DEFAULT_SIZE = 16;
+
+    bool Init(AudioBackend* audioBackend, int size = DEFAULT_SIZE);
+    void Release();
+
+    // Returns an invalid handle (index -1) if nothing could be stolen
+    VoiceHandle Play(ALuint buffer, VoicePriority priority, float gain = 1.0f);
+    void Stop(VoiceHandle handle);
+    bool IsPlaying(VoiceHandle handle) const;
+    void SetGain(VoiceHandle handle, float gain);
+    // The backend's estimate of when the handle's sound was first heard;
+    // false if it can't say (yet), or the voice has moved on to another sound
+    bool HeardAt(VoiceHandle handle, double& time) const;
+    // Stops every voice and detaches its buffer, so buffers can be deleted
+    void StopAll();
+
+    int LiveVoices() const;
+    int Size() const { return static_cast<int>(voices.size()); }
+
+private:
+    struct Voice {
+        uint32_t generation = 0;
+        uint64_t startedAt = 0;       // Play() sequence number, for oldest-first stealing
+        VoicePriority priority = VoicePriority::Music;
+        bool inUse = false;
+    };
+
+    bool IsBusy(int index) const;
+    int FindVoice(VoicePriority priority) const;
+
+    AudioBackend* backend = nullptr;
+    std::vector<Voice> voices;        // Same indices as the backend's voices
+    uint64_t playCounter = 0;
+};
@@ -0,0 +1,120 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>                  // std::find
+#include <cmath>                      // std::floor
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize > 0.0f ? cellSize : 1.0f) {
+}
+
+void SpatialGrid::Clear() {
+    entries.clear();
+    cells.clear();
+}
+
+int SpatialGrid::CellCoord(float v) const {
+    return static_cast<int>(std::floor(v / cellSize));
+}
+
+int64_t SpatialGrid::CellKey(int cx, int cy) {
+    return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cy);
+}
+
+void SpatialGrid::Link(int id) {
+    Entry& e = entries[id];
+    e.x0 = CellCoord(e.x);
+    e.y0 = CellCoord(e.y);
+    e.x1 = CellCoord(e.x + e.width);
+    e.y1 = CellCoord(e.y + e.height);
+    for (int cy = e.y0; cy <= e.y1; ++cy) {
+        for (int cx = e.x0; cx <= e.x1; ++cx) {
+            cells[CellKey(cx, cy)].push_back(id);
+        }
+    }
+}
+
+void SpatialGrid::Unlink(int id) {
+    Entry& e = entries[id];
+    for (int cy = e.y0; cy <= e.y1; ++cy) {
+        for (int cx = e.x0; cx <= e.x1; ++cx) {
+            auto cell = cells.find(CellKey(cx, cy));
+            if (cell == cells.end()) continue;
+
+            std::vector<int>& ids = cell->second;
+            auto it = std::find(ids.begin(), ids.end(), id);
+            if (it != ids.end()) {
+                *it = ids.back();
+                ids.pop_back();
+            }
+            // Emptied cells stay, so an entry moving back into them (a pop
+            // growing and shrinking) reuses their lists instead of allocating
+        }
+    }
+    e.x1 = e.x0 - 1;
+}
+
+void SpatialGrid::Insert(int id, float x, float y, float width, float height, int depth) {
+    if (id < 0) return;
+    if (id >= static_cast<int>(entries.size())) entries.resize(id + 1);
+    if (entries[id].live) Unlink(id);
+
+    Entry& e = entries[id];
+    e.x = x;
+    e.y = y;
+    e.width = width;
+    e.height = height;
+    e.depth = depth;
+    e.live = true;
+    Link(id);
+}
+
+void SpatialGrid::Update(int id, float x, float y, float width, float height) {
+    if (id < 0 || id >= static_cast<int>(entries.size()) || !entries[id].live) return;
+
+    Entry& e = entries[id];
+    e.x = x;
+    e.y = y;
+    e.width = width;
+    e.height = height;
+
+    // Small moves and the pop animation usually stay inside the same cells
+    if (CellCoord(x) == e.x0 && CellCoord(y) == e.y0 &&
+        CellCoord(x + width) == e.x1 && CellCoord(y + height) == e.y1) {
+        return;
+    }
+    Unlink(id);
+    Link(id);
+}
+
+void SpatialGrid::Remove(int id) {
+    if (id < 0 || id >= static_cast<int>(entries.size()) || !entries[id].live) return;
+
+    Unlink(id);
+    entries[id].live = false;
+}
+
+void SpatialGrid::Reserve(float x, float y, float width, float height) {
+    const int x0 = CellCoord(x), y0 = CellCoord(y);
+    const int x1 = CellCoord(x + width), y1 = CellCoord(y + height);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            std::vector<int>& ids = cells[CellKey(cx, cy)];
+            ids.reserve(ids.capacity() + 1);
+        }
+    }
+}
+
+int SpatialGrid::Query(float px, float py) const {
+    auto cell = cells.find(CellKey(CellCoord(px), CellCoord(py)));
+    if (cell == cells.end()) return -1;
+
+    int best = -1;
+    for (int id : cell->second) {
+        const Entry& e = entries[id];
+        if (px < e.x || px > e.x + e.width || py < e.y || py > e.y + e.height) continue;
+
+        if (best < 0 || e.depth > entries[best].depth || (e.depth == entries[best].depth && id > best)) {
+            best = id;
+        }
+    }
+    return best;
+}
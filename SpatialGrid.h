@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>                    // int64_t cell keys
+#include <unordered_map>              // Sparse cells, so the scene has no fixed bounds
+#include <vector>                     // Entries and per-cell lists
+
+// Uniform grid over axis-aligned rectangles for point hit-testing. Each
+// rectangle is listed in every cell it overlaps, so a query only looks at
+// the few rectangles sharing the point's cell instead of every entity in
+// the scene. Cells are created on demand, so scenes can extend in any
+// direction, and kept until Clear() once they empty. Ids are small
+// non-negative integers chosen by the caller.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 0.25f);
+
+    void Clear();
+
+    // Adds or replaces an entry. Higher depth is drawn on top; equal depths
+    // resolve to the higher id, as later entities are drawn later.
+    void Insert(int id, float x, float y, float width, float height, int depth);
+    // Moves or resizes an entry, only touching the cells that changed
+    void Update(int id, float x, float y, float width, float height);
+    void Remove(int id);
+    // Makes room for one more entry in every cell the rectangle covers, so an
+    // entry later placed there doesn't allocate. Reserve each place an entry
+    // can go once, after Clear().
+    void Reserve(float x, float y, float width, float height);
+
+    // The topmost entry containing the point (edges included), or -1
+    int Query(float px, float py) const;
+
+private:
+    struct Entry {
+        float x = 0.0f, y = 0.0f, width = 0.0f, height = 0.0f;
+        int depth = 0;
+        int x0 = 0, y0 = 0, x1 = -1, y1 = -1;  // Cell range it is listed in; empty when x1 < x0
+        bool live = false;
+    };
+
+    int CellCoord(float v) const;
+    static int64_t CellKey(int cx, int cy);
+    void Link(int id);
+    void Unlink(int id);
+
+    float cellSize;
+    std::vector<Entry> entries;       // Indexed by id
+    std::unordered_map<int64_t, std::vector<int>> cells;
+};
@@ -0,0 +1,315 @@
+#define _USE_MATH_DEFINES             // M_PI; must come before anything pulls in <cmath>
+#include "SpriteBatch.h"
+
+#include <cmath>                      // Corner arcs
+#include <cstring>                    // strlen for the program cache key
+#include <iostream>                   // Error reporting
+
+#include "WarmCache.h"               // Program binaries from earlier launches
+
+namespace {
+
+// Attribute slots shared by every program linked through LinkProgram()
+const GLuint ATTRIB_POSITION = 0;
+const GLuint ATTRIB_TEXCOORD = 1;
+const GLuint ATTRIB_COLOR = 2;
+
+const char* SPRITE_VERTEX_SHADER = R"(
+#version 120
+attribute vec2 aPosition;
+attribute vec2 aTexCoord;
+attribute vec4 aColor;
+varying vec2 vTexCoord;
+varying vec4 vColor;
+void main() {
+    vTexCoord = aTexCoord;
+    vColor = aColor;
+    gl_Position = vec4(aPosition, 0.0, 1.0);
+}
+)";
+
+const char* SPRITE_FRAGMENT_SHADER = R"(
+#version 120
+uniform sampler2D uTexture;
+varying vec2 vTexCoord;
+varying vec4 vColor;
+void main() {
+    gl_FragColor = texture2D(uTexture, vTexCoord) * vColor;
+}
+)";
+
+} // namespace
+
+GLuint CompileShader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Shader compile error: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint LinkProgram(GLuint vertexShader, GLuint fragmentShader, bool retrievable) {
+    if (!vertexShader || !fragmentShader) return 0;
+
+    GLuint program = glCreateProgram();
+    if (retrievable) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glBindAttribLocation(program, ATTRIB_POSITION, "aPosition");
+    glBindAttribLocation(program, ATTRIB_TEXCOORD, "aTexCoord");
+    glBindAttribLocation(program, ATTRIB_COLOR, "aColor");
+    glLinkProgram(program);
+
+    // The program keeps what it needs; the shader objects can go
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "Shader link error: " << log << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+GLuint BuildProgram(const char* vertexSource, const char* fragmentSource) {
+    const WarmCache* cache = GetWarmCache();
+    const bool binaries = cache && cache->IsOpen() && (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary);
+    if (!binaries) {
+        return LinkProgram(CompileShader(GL_VERTEX_SHADER, vertexSource),
+            CompileShader(GL_FRAGMENT_SHADER, fragmentSource));
+    }
+
+    // A binary only loads on the driver that made it, so the driver is part of the key
+    uint64_t key = WarmCache::Hash(vertexSource, strlen(vertexSource));
+    key = WarmCache::Hash(fragmentSource, strlen(fragmentSource), key);
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+        if (value) key = WarmCache::Hash(value, strlen(value), key);
+    }
+
+    uint32_t format;
+    std::vector<unsigned char> binary;
+    if (cache->LoadProgram(key, format, binary)) {
+        GLuint program = glCreateProgram();
+        glProgramBinary(program, format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (ok) return program;
+        glDeleteProgram(program);  // The driver turned it down after all; rebuild and replace it
+    }
+
+    GLuint program = LinkProgram(CompileShader(GL_VERTEX_SHADER, vertexSource),
+        CompileShader(GL_FRAGMENT_SHADER, fragmentSource), true);
+    if (!program) return 0;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length > 0) {
+        binary.resize(static_cast<size_t>(length));
+        GLenum binaryFormat = 0;
+        glGetProgramBinary(program, length, nullptr, &binaryFormat, binary.data());
+        cache->StoreProgram(key, binaryFormat, binary.data(), binary.size());
+    }
+    return program;
+}
+
+bool SpriteBatch::Init() {
+    if (!GLEW_VERSION_2_0) {
+        std::cerr << "OpenGL 2.0 is required for the sprite renderer" << std::endl;
+        return false;
+    }
+
+    program = BuildProgram(SPRITE_VERTEX_SHADER, SPRITE_FRAGMENT_SHADER);
+    if (!program) return false;
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "uTexture"), 0);
+    glUseProgram(0);
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Solid-color geometry samples this so it can share the textured shader
+    const unsigned char white[4] = { 255, 255, 255, 255 };
+    glGenTextures(1, &whiteTexture);
+    glBindTexture(GL_TEXTURE_2D, whiteTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    vertices.reserve(MAX_VERTICES);
+    return true;
+}
+
+void SpriteBatch::Release() {
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (program) glDeleteProgram(program);
+    if (whiteTexture) glDeleteTextures(1, &whiteTexture);
+    vbo = program = whiteTexture = 0;
+}
+
+// Points the attributes at whatever SpriteVertex buffer is currently bound
+void SpriteBatch::BindVertexLayout() {
+    const GLsizei stride = sizeof(SpriteVertex);
+    glVertexAttribPointer(ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SpriteVertex, x));
+    glVertexAttribPointer(ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SpriteVertex, u));
+    glVertexAttribPointer(ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SpriteVertex, r));
+}
+
+void SpriteBatch::Begin() {
+    glUseProgram(program);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    glEnableVertexAttribArray(ATTRIB_POSITION);
+    glEnableVertexAttribArray(ATTRIB_TEXCOORD);
+    glEnableVertexAttribArray(ATTRIB_COLOR);
+    BindVertexLayout();
+
+    glActiveTexture(GL_TEXTURE0);
+    currentTexture = 0;
+}
+
+void SpriteBatch::End() {
+    Flush();
+
+    glDisableVertexAttribArray(ATTRIB_POSITION);
+    glDisableVertexAttribArray(ATTRIB_TEXCOORD);
+    glDisableVertexAttribArray(ATTRIB_COLOR);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+    currentTexture = 0;
+}
+
+void SpriteBatch::SetTexture(GLuint texture) {
+    if (texture == 0) texture = whiteTexture;
+    if (texture != currentTexture) {
+        Flush();
+        glBindTexture(GL_TEXTURE_2D, texture);
+        currentTexture = texture;
+        ++textureBinds;
+    }
+}
+
+void SpriteBatch::Flush() {
+    if (vertices.empty()) return;
+
+    // Orphan the old storage, then fill a fresh copy
+    glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(SpriteVertex), vertices.data());
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    ++drawCalls;
+
+    vertices.clear();
+}
+
+void SpriteBatch::Draw(GLuint texture, float x, float y, float width, float height, const UVRect& uv, const glm::vec4& color) {
+    SetTexture(texture);
+    if (vertices.size() + 6 > MAX_VERTICES) Flush();
+
+    // UV v0 is the top row of the image, so it goes on the top edge
+    const SpriteVertex bl = { x, y, uv.u0, uv.v1, color.r, color.g, color.b, color.a };
+    const SpriteVertex br = { x + width, y, uv.u1, uv.v1, color.r, color.g, color.b, color.a };
+    const SpriteVertex tr = { x + width, y + height, uv.u1, uv.v0, color.r, color.g, color.b, color.a };
+    const SpriteVertex tl = { x, y + height, uv.u0, uv.v0, color.r, color.g, color.b, color.a };
+
+    vertices.push_back(bl);
+    vertices.push_back(br);
+    vertices.push_back(tr);
+    vertices.push_back(bl);
+    vertices.push_back(tr);
+    vertices.push_back(tl);
+}
+
+void SpriteBatch::DrawRect(float x, float y, float width, float height, const glm::vec4& color) {
+    Draw(0, x, y, width, height, UVRect(), color);
+}
+
+void SpriteBatch::DrawTriangles(GLuint texture, const SpriteVertex* verts, size_t count) {
+    SetTexture(texture);
+    if (vertices.size() + count > MAX_VERTICES) Flush();
+    vertices.insert(vertices.end(), verts, verts + count);
+}
+
+void SpriteBatch::DrawStatic(const StaticMesh& mesh, GLuint texture) {
+    if (!mesh.vbo || mesh.count == 0) return;
+
+    SetTexture(texture);
+    Flush();  // Keep submission order
+
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+    BindVertexLayout();
+    glDrawArrays(GL_TRIANGLES, 0, mesh.count);
+    ++drawCalls;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    BindVertexLayout();
+}
+
+void StaticMesh::Upload(const std::vector<SpriteVertex>& verts) {
+    if (!vbo) glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, verts.size() * sizeof(SpriteVertex), verts.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    count = static_cast<GLsizei>(verts.size());
+}
+
+void StaticMesh::Release() {
+    if (vbo) glDeleteBuffers(1, &vbo);
+    vbo = 0;
+    count = 0;
+}
+
+void TessellateRoundedRect(std::vector<SpriteVertex>& out, float x, float y, float width, float height,
+    float radius, int segments, const glm::vec4& color) {
+    auto vertex = [&](float vx, float vy) {
+        out.push_back({ vx, vy, 0.0f, 0.0f, color.r, color.g, color.b, color.a });
+    };
+    auto rect = [&](float rx, float ry, float rw, float rh) {
+        vertex(rx, ry); vertex(rx + rw, ry); vertex(rx + rw, ry + rh);
+        vertex(rx, ry); vertex(rx + rw, ry + rh); vertex(rx, ry + rh);
+    };
+
+    // Cross-shaped middle: one tall strip and the two side strips between the corners
+    rect(x + radius, y, width - 2 * radius, height);
+    rect(x, y + radius, radius, height - 2 * radius);
+    rect(x + width - radius, y + radius, radius, height - 2 * radius);
+
+    // Quarter-circle fans in the corners, as plain triangles
+    const float pi = static_cast<float>(M_PI);
+    const float centers[4][2] = {
+        { x + radius, y + radius },
+        { x + width - radius, y + radius },
+        { x + width - radius, y + height - radius },
+        { x + radius, y + height - radius },
+    };
+    const float startAngles[4] = { pi, 1.5f * pi, 0.0f, 0.5f * pi };
+
+    for (int corner = 0; corner < 4; ++corner) {
+        const float cx = centers[corner][0];
+        const float cy = centers[corner][1];
+        for (int i = 0; i < segments; ++i) {
+            float a0 = startAngles[corner] + i * (pi / 2) / segments;
+            float a1 = startAngles[corner] + (i + 1) * (pi / 2) / segments;
+            vertex(cx, cy);
+            vertex(cx + std::cos(a0) * radius, cy + std::sin(a0) * radius);
+            vertex(cx + std::cos(a1) * radius, cy + std::sin(a1) * radius);
+        }
+    }
+}
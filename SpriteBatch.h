@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <vector>                     // CPU-side vertex staging
+
+#include <glew.h>                     // Buffers, shaders
+#include <glm/glm.hpp>               // glm::vec4 colors
+
+#include "TextureAtlas.h"            // UVRect
+
+struct SpriteVertex {
+    float x, y;                       // Normalized device coordinates
+    float u, v;
+    float r, g, b, a;
+};
+
+// Geometry that rarely changes, kept in its own GL_STATIC_DRAW buffer and drawn
+// with a single call. Re-upload only when the layout it was built from changes.
+struct StaticMesh {
+    GLuint vbo = 0;
+    GLsizei count = 0;
+
+    void Upload(const std::vector<SpriteVertex>& verts);
+    void Release();
+};
+
+// Collects textured, colored triangles for a frame and draws them with as few
+// glDrawArrays calls as possible. Geometry is flushed only when the texture
+// changes, the buffer fills up, or End() is called. The vertex buffer is
+// orphaned on each flush so the driver never stalls on a buffer still in use.
+//
+// Positions are in normalized device coordinates, same as the rest of the game.
+class SpriteBatch {
+public:
+    static const size_t MAX_VERTICES = 6 * 4096;
+
+    bool Init();
+    void Release();
+
+    // Binds the shader/buffer. Fixed-function drawing (e.g. DrawText) must not
+    // happen between Begin() and End().
+    void Begin();
+    void End();
+
+    // texture == 0 draws solid color
+    void Draw(GLuint texture, float x, float y, float width, float height, const UVRect& uv, const glm::vec4& color);
+    void DrawRect(float x, float y, float width, float height, const glm::vec4& color);
+    void DrawTriangles(GLuint texture, const SpriteVertex* verts, size_t count);
+    void DrawStatic(const StaticMesh& mesh, GLuint texture);
+
+    int DrawCalls() const { return drawCalls; }
+    int TextureBinds() const { return textureBinds; }
+    void ResetCounters() { drawCalls = 0; textureBinds = 0; }
+
+private:
+    void SetTexture(GLuint texture);
+    void Flush();
+    static void BindVertexLayout();
+
+    std::vector<SpriteVertex> vertices;
+    GLuint program = 0;
+    GLuint vbo = 0;
+    GLuint whiteTexture = 0;
+    GLuint currentTexture = 0;
+
+    int drawCalls = 0;
+    int textureBinds = 0;
+};
+
+// Appends a filled rounded rectangle as triangles. More segments = smoother corners.
+void TessellateRoundedRect(std::vector<SpriteVertex>& out, float x, float y, float width, float height,
+    float radius, int segments, const glm::vec4& color);
+
+// Shared helpers for the small GLSL programs used by the renderers
+GLuint CompileShader(GLenum type, const char* source);
+// `retrievable` asks the driver to keep the binary for glGetProgramBinary
+GLuint LinkProgram(GLuint vertexShader, GLuint fragmentShader, bool retrievable = false);
+// Compiles and links, or loads the binary the warm-start cache kept from an
+// earlier launch on the same driver (see WarmCache.h)
+GLuint BuildProgram(const char* vertexSource, const char* fragmentSource);
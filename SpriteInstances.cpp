@@ -0,0 +1,157 @@
+#include "SpriteInstances.h"
+
+#include <cstring>                    // memcmp
+#include <iostream>                   // Error reporting
+
+#include "SpriteBatch.h"             // BuildProgram
+
+namespace {
+
+// Runs of changed instances closer than this are sent as one upload
+const size_t MERGE_GAP = 8;
+
+// The corner arrives as aPosition so LinkProgram() puts it in slot 0, which
+// some compatibility drivers insist is a per-vertex array
+const char* INSTANCE_VERTEX_SHADER = R"(
+#version 120
+attribute vec2 aPosition;
+attribute vec4 aRect;
+attribute vec4 aUV;
+varying vec2 vTexCoord;
+void main() {
+    vTexCoord = vec2(mix(aUV.x, aUV.z, aPosition.x), mix(aUV.w, aUV.y, aPosition.y));
+    gl_Position = vec4(aRect.xy + aPosition * aRect.zw, 0.0, 1.0);
+}
+)";
+
+const char* INSTANCE_FRAGMENT_SHADER = R"(
+#version 120
+uniform sampler2D uTexture;
+varying vec2 vTexCoord;
+void main() {
+    gl_FragColor = texture2D(uTexture, vTexCoord);
+}
+)";
+
+bool SameInstance(const SpriteInstance& a, const SpriteInstance& b) {
+    return memcmp(&a, &b, sizeof(SpriteInstance)) == 0;
+}
+
+} // namespace
+
+void InstanceBuffer::Set(const SpriteInstance* instances, size_t count) {
+    if (!vbo) glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if (count != uploaded.size()) {
+        // A different scene; nothing to compare against
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(SpriteInstance), instances, GL_DYNAMIC_DRAW);
+        uploaded.assign(instances, instances + count);
+        lastUploaded = count;
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    lastUploaded = 0;
+    size_t i = 0;
+    while (i < count) {
+        if (SameInstance(instances[i], uploaded[i])) {
+            ++i;
+            continue;
+        }
+
+        // Extend the run while the next change is within MERGE_GAP
+        size_t end = i + 1;
+        size_t unchanged = 0;
+        for (size_t j = end; j < count && unchanged < MERGE_GAP; ++j) {
+            if (SameInstance(instances[j], uploaded[j])) {
+                ++unchanged;
+            }
+            else {
+                end = j + 1;
+                unchanged = 0;
+            }
+        }
+
+        std::memcpy(&uploaded[i], &instances[i], (end - i) * sizeof(SpriteInstance));
+        glBufferSubData(GL_ARRAY_BUFFER, i * sizeof(SpriteInstance), (end - i) * sizeof(SpriteInstance), &instances[i]);
+        lastUploaded += end - i;
+        i = end;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::Release() {
+    if (vbo) glDeleteBuffers(1, &vbo);
+    vbo = 0;
+    uploaded.clear();
+}
+
+bool InstancedSprites::Supported() {
+    return GLEW_VERSION_3_3 != 0;
+}
+
+bool InstancedSprites::Init() {
+    if (!Supported()) return false;
+
+    program = BuildProgram(INSTANCE_VERTEX_SHADER, INSTANCE_FRAGMENT_SHADER);
+    if (!program) return false;
+
+    rectAttrib = glGetAttribLocation(program, "aRect");
+    uvAttrib = glGetAttribLocation(program, "aUV");
+    if (rectAttrib < 0 || uvAttrib < 0) {
+        std::cerr << "Instanced sprite shader is missing its per-instance attributes" << std::endl;
+        Release();
+        return false;
+    }
+
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "uTexture"), 0);
+    glUseProgram(0);
+
+    const float corners[12] = { 0, 0, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1 };
+    glGenBuffers(1, &quad);
+    glBindBuffer(GL_ARRAY_BUFFER, quad);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void InstancedSprites::Release() {
+    if (quad) glDeleteBuffers(1, &quad);
+    if (program) glDeleteProgram(program);
+    quad = program = 0;
+}
+
+void InstancedSprites::Draw(const InstanceBuffer& instances, GLuint texture) {
+    if (!program || instances.Count() == 0) return;
+
+    glUseProgram(program);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    glBindBuffer(GL_ARRAY_BUFFER, quad);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    const GLsizei stride = sizeof(SpriteInstance);
+    glBindBuffer(GL_ARRAY_BUFFER, instances.Buffer());
+    glEnableVertexAttribArray(rectAttrib);
+    glVertexAttribPointer(rectAttrib, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SpriteInstance, x));
+    glVertexAttribDivisor(rectAttrib, 1);
+    glEnableVertexAttribArray(uvAttrib);
+    glVertexAttribPointer(uvAttrib, 4, GL_FLOAT, GL_FALSE, stride, (const void*)offsetof(SpriteInstance, u0));
+    glVertexAttribDivisor(uvAttrib, 1);
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, instances.Count());
+    ++drawCalls;
+
+    // The sprite batch expects every attribute per-vertex again
+    glVertexAttribDivisor(rectAttrib, 0);
+    glVertexAttribDivisor(uvAttrib, 0);
+    glDisableVertexAttribArray(rectAttrib);
+    glDisableVertexAttribArray(uvAttrib);
+    glDisableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
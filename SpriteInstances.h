@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <vector>                     // CPU copy of the uploaded instances
+
+#include <glew.h>                     // Instance buffers, shaders
+
+// One textured rectangle of an instanced draw. Positions are in normalized
+// device coordinates; v0 is the top row of the image, as in UVRect.
+struct SpriteInstance {
+    float x, y, width, height;
+    float u0, v0, u1, v1;
+};
+
+// Per-instance data for one InstancedSprites::Draw(), e.g. every animal of a
+// board. Set() compares against what the GPU already holds and uploads only
+// the instances that changed, one glBufferSubData per run of them, so a
+// scene of hundreds of sprites where a few are animating sends a few.
+class InstanceBuffer {
+public:
+    void Set(const SpriteInstance* instances, size_t count);
+    void Release();
+
+    GLuint Buffer() const { return vbo; }
+    GLsizei Count() const { return static_cast<GLsizei>(uploaded.size()); }
+    // Instances re-sent by the last Set()
+    size_t Uploaded() const { return lastUploaded; }
+
+private:
+    GLuint vbo = 0;
+    std::vector<SpriteInstance> uploaded;
+    size_t lastUploaded = 0;
+};
+
+// Draws every instance of a buffer as the same unit quad, scaled and
+// textured per instance, with a single glDrawArraysInstanced for the whole
+// atlas page. Needs GL 3.3 for attribute divisors; callers fall back to
+// SpriteBatch without it.
+class InstancedSprites {
+public:
+    static bool Supported();
+
+    bool Init();
+    void Release();
+
+    // Call outside SpriteBatch::Begin()/End(); draws untinted, blended as usual
+    void Draw(const InstanceBuffer& instances, GLuint texture);
+
+    int DrawCalls() const { return drawCalls; }
+    void ResetCounters() { drawCalls = 0; }
+
+private:
+    GLuint program = 0;
+    GLuint quad = 0;                  // Six corners of the unit square
+    GLint rectAttrib = -1;
+    GLint uvAttrib = -1;
+    int drawCalls = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>                     // Head/tail indices shared between threads
+#include <cstddef>                    // size_t
+
+// Fixed-capacity lock-free queue for exactly one producer thread and one
+// consumer thread. Capacity must be a power of two; one slot is kept empty
+// to tell full from empty, so it holds Capacity - 1 items.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. Returns false (and drops the item) when full.
+    bool Push(const T& item) {
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) & (Capacity - 1);
+        if (next == headIndex.load(std::memory_order_acquire)) return false;
+
+        items[tail] = item;
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when empty.
+    bool Pop(T& item) {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return false;
+
+        item = items[head];
+        headIndex.store((head + 1) & (Capacity - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Only approximate while the other side is running
+    size_t Size() const {
+        const size_t head = headIndex.load(std::memory_order_acquire);
+        const size_t tail = tailIndex.load(std::memory_order_acquire);
+        return (tail - head) & (Capacity - 1);
+    }
+
+private:
+    T items[Capacity];
+    alignas(64) std::atomic<size_t> headIndex{ 0 };
+    alignas(64) std::atomic<size_t> tailIndex{ 0 };
+};
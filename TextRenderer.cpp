@@ -0,0 +1,214 @@
+#include "TextRenderer.h"
+
+#include <cctype>                     // std::toupper
+#include <cmath>                      // std::floor
+
+namespace {
+
+struct GlyphBitmap {
+    char ch;
+    const char* rows[TextRenderer::GLYPH_ROWS];
+};
+
+// 5x7 capitals, digits and common punctuation. '#' = lit font pixel.
+const GlyphBitmap FONT[] = {
+    { ' ', { ".....", ".....", ".....", ".....", ".....", ".....", "....." } },
+    { '!', { "..#..", "..#..", "..#..", "..#..", "..#..", ".....", "..#.." } },
+    { '"', { ".#.#.", ".#.#.", ".....", ".....", ".....", ".....", "....." } },
+    { '#', { ".#.#.", ".#.#.", "#####", ".#.#.", "#####", ".#.#.", ".#.#." } },
+    { '%', { "##...", "##..#", "...#.", "..#..", ".#...", "#..##", "...##" } },
+    { '\'', { "..#..", "..#..", ".....", ".....", ".....", ".....", "....." } },
+    { '(', { "...#.", "..#..", ".#...", ".#...", ".#...", "..#..", "...#." } },
+    { ')', { ".#...", "..#..", "...#.", "...#.", "...#.", "..#..", ".#..." } },
+    { '*', { ".....", "..#..", "#.#.#", ".###.", "#.#.#", "..#..", "....." } },
+    { '+', { ".....", "..#..", "..#..", "#####", "..#..", "..#..", "....." } },
+    { ',', { ".....", ".....", ".....", ".....", ".##..", "..#..", ".#..." } },
+    { '-', { ".....", ".....", ".....", "#####", ".....", ".....", "....." } },
+    { '.', { ".....", ".....", ".....", ".....", ".....", ".##..", ".##.." } },
+    { '/', { ".....", "....#", "...#.", "..#..", ".#...", "#....", "....." } },
+    { '0', { ".###.", "#...#", "#..##", "#.#.#", "##..#", "#...#", ".###." } },
+    { '1', { "..#..", ".##..", "..#..", "..#..", "..#..", "..#..", ".###." } },
+    { '2', { ".###.", "#...#", "....#", "...#.", "..#..", ".#...", "#####" } },
+    { '3', { "#####", "...#.", "..#..", "...#.", "....#", "#...#", ".###." } },
+    { '4', { "...#.", "..##.", ".#.#.", "#..#.", "#####", "...#.", "...#." } },
+    { '5', { "#####", "#....", "####.", "....#", "....#", "#...#", ".###." } },
+    { '6', { "..##.", ".#...", "#....", "####.", "#...#", "#...#", ".###." } },
+    { '7', { "#####", "....#", "...#.", "..#..", ".#...", ".#...", ".#..." } },
+    { '8', { ".###.", "#...#", "#...#", ".###.", "#...#", "#...#", ".###." } },
+    { '9', { ".###.", "#...#", "#...#", ".####", "....#", "...#.", ".##.." } },
+    { ':', { ".....", ".##..", ".##..", ".....", ".##..", ".##..", "....." } },
+    { ';', { ".....", ".##..", ".##..", ".....", ".##..", "..#..", ".#..." } },
+    { '<', { "...#.", "..#..", ".#...", "#....", ".#...", "..#..", "...#." } },
+    { '=', { ".....", ".....", "#####", ".....", "#####", ".....", "....." } },
+    { '>', { ".#...", "..#..", "...#.", "....#", "...#.", "..#..", ".#..." } },
+    { '?', { ".###.", "#...#", "....#", "...#.", "..#..", ".....", "..#.." } },
+    { 'A', { ".###.", "#...#", "#...#", "#####", "#...#", "#...#", "#...#" } },
+    { 'B', { "####.", "#...#", "#...#", "####.", "#...#", "#...#", "####." } },
+    { 'C', { ".###.", "#...#", "#....", "#....", "#....", "#...#", ".###." } },
+    { 'D', { "###..", "#..#.", "#...#", "#...#", "#...#", "#..#.", "###.." } },
+    { 'E', { "#####", "#....", "#....", "####.", "#....", "#....", "#####" } },
+    { 'F', { "#####", "#....", "#....", "####.", "#....", "#....", "#...." } },
+    { 'G', { ".###.", "#...#", "#....", "#.###", "#...#", "#...#", ".####" } },
+    { 'H', { "#...#", "#...#", "#...#", "#####", "#...#", "#...#", "#...#" } },
+    { 'I', { ".###.", "..#..", "..#..", "..#..", "..#..", "..#..", ".###." } },
+    { 'J', { "..###", "...#.", "...#.", "...#.", "...#.", "#..#.", ".##.." } },
+    { 'K', { "#...#", "#..#.", "#.#..", "##...", "#.#..", "#..#.", "#...#" } },
+    { 'L', { "#....", "#....", "#....", "#....", "#....", "#....", "#####" } },
+    { 'M', { "#...#", "##.##", "#.#.#", "#.#.#", "#...#", "#...#", "#...#" } },
+    { 'N', { "#...#", "#...#", "##..#", "#.#.#", "#..##", "#...#", "#...#" } },
+    { 'O', { ".###.", "#...#", "#...#", "#...#", "#...#", "#...#", ".###." } },
+    { 'P', { "####.", "#...#", "#...#", "####.", "#....", "#....", "#...." } },
+    { 'Q', { ".###.", "#...#", "#...#", "#...#", "#.#.#", "#..#.", ".##.#" } },
+    { 'R', { "####.", "#...#", "#...#", "####.", "#.#..", "#..#.", "#...#" } },
+    { 'S', { ".####", "#....", "#....", ".###.", "....#", "....#", "####." } },
+    { 'T', { "#####", "..#..", "..#..", "..#..", "..#..", "..#..", "..#.." } },
+    { 'U', { "#...#", "#...#", "#...#", "#...#", "#...#", "#...#", ".###." } },
+    { 'V', { "#...#", "#...#", "#...#", "#...#", "#...#", ".#.#.", "..#.." } },
+    { 'W', { "#...#", "#...#", "#...#", "#.#.#", "#.#.#", "#.#.#", ".#.#." } },
+    { 'X', { "#...#", "#...#", ".#.#.", "..#..", ".#.#.", "#...#", "#...#" } },
+    { 'Y', { "#...#", "#...#", ".#.#.", "..#..", "..#..", "..#..", "..#.." } },
+    { 'Z', { "#####", "....#", "...#.", "..#..", ".#...", "#....", "#####" } },
+    { '[', { ".###.", ".#...", ".#...", ".#...", ".#...", ".#...", ".###." } },
+    { ']', { ".###.", "...#.", "...#.", "...#.", "...#.", "...#.", ".###." } },
+    { '_', { ".....", ".....", ".....", ".....", ".....", ".....", "#####" } },
+};
+
+// Glyph texture layout: one cell per ASCII code 32..127, 16 cells per row
+const int FIRST_CHAR = 32;
+const int CHAR_COUNT = 96;
+const int ATLAS_COLUMNS = 16;
+const int CELL_PAD = 1;           // Empty texels around each glyph
+const int CELL_W = TextRenderer::GLYPH_COLS * TextRenderer::PIXEL_SCALE + 2 * CELL_PAD;
+const int CELL_H = TextRenderer::GLYPH_ROWS * TextRenderer::PIXEL_SCALE + 2 * CELL_PAD;
+const int ATLAS_W = ATLAS_COLUMNS * CELL_W;
+const int ATLAS_H = (CHAR_COUNT / ATLAS_COLUMNS) * CELL_H;
+
+const int GLYPH_W = TextRenderer::GLYPH_COLS * TextRenderer::PIXEL_SCALE;
+const int GLYPH_H = TextRenderer::GLYPH_ROWS * TextRenderer::PIXEL_SCALE;
+const int ADVANCE = (TextRenderer::GLYPH_COLS + 1) * TextRenderer::PIXEL_SCALE;
+
+int GlyphIndex(char c) {
+    int code = std::toupper(static_cast<unsigned char>(c));
+    if (code < FIRST_CHAR || code >= FIRST_CHAR + CHAR_COUNT) code = '?';
+    return code - FIRST_CHAR;
+}
+
+// The six vertices of one glyph quad. (px, top) is its top-left corner in pixels.
+void GlyphQuad(SpriteVertex* out, int glyph, float px, float top, int viewW, int viewH, const glm::vec4& c) {
+    const float cellX = static_cast<float>((glyph % ATLAS_COLUMNS) * CELL_W + CELL_PAD);
+    const float cellY = static_cast<float>((glyph / ATLAS_COLUMNS) * CELL_H + CELL_PAD);
+    const float u0 = cellX / ATLAS_W, u1 = (cellX + GLYPH_W) / ATLAS_W;
+    const float v0 = cellY / ATLAS_H, v1 = (cellY + GLYPH_H) / ATLAS_H;
+
+    const float x0 = px * 2.0f / viewW - 1.0f;
+    const float x1 = (px + GLYPH_W) * 2.0f / viewW - 1.0f;
+    const float y0 = 1.0f - (top + GLYPH_H) * 2.0f / viewH;  // Bottom edge
+    const float y1 = 1.0f - top * 2.0f / viewH;
+
+    out[0] = { x0, y0, u0, v1, c.r, c.g, c.b, c.a };
+    out[1] = { x1, y0, u1, v1, c.r, c.g, c.b, c.a };
+    out[2] = { x1, y1, u1, v0, c.r, c.g, c.b, c.a };
+    out[3] = out[0];
+    out[4] = out[2];
+    out[5] = { x0, y1, u0, v0, c.r, c.g, c.b, c.a };
+}
+
+// Calls emit(quad) with the six vertices of every visible glyph in the string
+template <typename Emit>
+void LayoutGlyphs(const char* text, float normX, float normY, int viewW, int viewH, const glm::vec4& color, Emit emit) {
+    // Snap the baseline to a whole pixel so the nearest-filtered glyphs stay crisp
+    float px = std::floor((normX + 1.0f) * viewW / 2.0f);
+    float top = std::floor((1.0f - normY) * viewH / 2.0f) - GLYPH_H;
+
+    SpriteVertex quad[6];
+    for (; *text; ++text) {
+        const char c = *text;
+        if (c != ' ') {
+            GlyphQuad(quad, GlyphIndex(c), px, top, viewW, viewH, color);
+            emit(quad);
+        }
+        px += ADVANCE;
+    }
+}
+
+} // namespace
+
+bool TextRenderer::Init() {
+    // Bake every glyph once; white everywhere so only alpha carries the shape
+    std::vector<unsigned char> texels(static_cast<size_t>(ATLAS_W) * ATLAS_H * 4, 255);
+    for (size_t i = 3; i < texels.size(); i += 4) texels[i] = 0;
+
+    for (const GlyphBitmap& glyph : FONT) {
+        int index = glyph.ch - FIRST_CHAR;
+        int originX = (index % ATLAS_COLUMNS) * CELL_W + CELL_PAD;
+        int originY = (index / ATLAS_COLUMNS) * CELL_H + CELL_PAD;
+        for (int row = 0; row < GLYPH_ROWS; ++row) {
+            for (int col = 0; col < GLYPH_COLS; ++col) {
+                if (glyph.rows[row][col] != '#') continue;
+                for (int sy = 0; sy < PIXEL_SCALE; ++sy) {
+                    for (int sx = 0; sx < PIXEL_SCALE; ++sx) {
+                        int tx = originX + col * PIXEL_SCALE + sx;
+                        int ty = originY + row * PIXEL_SCALE + sy;
+                        texels[(static_cast<size_t>(ty) * ATLAS_W + tx) * 4 + 3] = 255;
+                    }
+                }
+            }
+        }
+    }
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, ATLAS_W, ATLAS_H, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture != 0;
+}
+
+void TextRenderer::Release() {
+    if (texture) glDeleteTextures(1, &texture);
+    texture = 0;
+}
+
+void TextRenderer::SetViewport(int width, int height) {
+    viewWidth = width > 0 ? width : 1;
+    viewHeight = height > 0 ? height : 1;
+}
+
+void TextRenderer::SetRun(TextRun& run, const std::string& text, float normX, float normY, const glm::vec4& color) const {
+    run.text = text;
+    run.normX = normX;
+    run.normY = normY;
+    run.color = color;
+    BuildRun(run);
+}
+
+void TextRenderer::BuildRun(TextRun& run) const {
+    run.verts.clear();
+    AppendGlyphs(run.verts, run.text.c_str(), run.normX, run.normY, run.color);
+    run.builtWidth = viewWidth;
+    run.builtHeight = viewHeight;
+}
+
+void TextRenderer::Draw(SpriteBatch& batch, TextRun& run) const {
+    if (run.builtWidth != viewWidth || run.builtHeight != viewHeight) {
+        BuildRun(run);
+    }
+    batch.DrawTriangles(texture, run.verts.data(), run.verts.size());
+}
+
+void TextRenderer::DrawString(SpriteBatch& batch, const char* text, float normX, float normY, const glm::vec4& color) const {
+    LayoutGlyphs(text, normX, normY, viewWidth, viewHeight, color, [&](const SpriteVertex* quad) {
+        batch.DrawTriangles(texture, quad, 6);
+    });
+}
+
+void TextRenderer::AppendGlyphs(std::vector<SpriteVertex>& out, const char* text, float normX, float normY, const glm::vec4& color) const {
+    LayoutGlyphs(text, normX, normY, viewWidth, viewHeight, color, [&](const SpriteVertex* quad) {
+        out.insert(out.end(), quad, quad + 6);
+    });
+}
+
+float TextRenderer::TextWidth(const std::string& text) const {
+    return static_cast<float>(text.size() * ADVANCE) * 2.0f / viewWidth;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>                     // std::string text
+#include <vector>                     // Cached glyph quads
+
+#include <glew.h>                     // GLuint glyph texture
+#include <glm/glm.hpp>               // glm::vec4 colors
+
+#include "SpriteBatch.h"             // SpriteVertex, batch submission
+
+// Pre-built glyph quads for a string that rarely changes (button labels,
+// headings). Rebuilt automatically when the viewport size changes.
+struct TextRun {
+    std::string text;
+    float normX = 0.0f;
+    float normY = 0.0f;
+    glm::vec4 color = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    std::vector<SpriteVertex> verts;
+    int builtWidth = 0;
+    int builtHeight = 0;
+};
+
+// Draws text from a small built-in bitmap font baked into one texture at
+// startup. Glyphs are sized in pixels, so text keeps the same on-screen size
+// whatever the window size, like the old GLUT bitmap fonts. Lowercase letters
+// are drawn as capitals.
+class TextRenderer {
+public:
+    static const int GLYPH_COLS = 5;  // Font cell size in font pixels
+    static const int GLYPH_ROWS = 7;
+    static const int PIXEL_SCALE = 2; // Screen pixels per font pixel
+
+    bool Init();
+    void Release();
+
+    // Framebuffer size the text is laid out for
+    void SetViewport(int width, int height);
+
+    // (normX, normY) is the left end of the baseline, in NDC
+    void SetRun(TextRun& run, const std::string& text, float normX, float normY, const glm::vec4& color) const;
+    void Draw(SpriteBatch& batch, TextRun& run) const;
+    // For text that changes every frame; takes the characters as they are, so nothing is copied
+    void DrawString(SpriteBatch& batch, const char* text, float normX, float normY, const glm::vec4& color) const;
+
+    float TextWidth(const std::string& text) const;  // In NDC
+
+private:
+    void BuildRun(TextRun& run) const;
+    void AppendGlyphs(std::vector<SpriteVertex>& out, const char* text, float normX, float normY, const glm::vec4& color) const;
+
+    GLuint texture = 0;
+    int viewWidth = 1;
+    int viewHeight = 1;
+};
@@ -0,0 +1,122 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>                  // std::sort, std::min, std::max
+#include <cstdint>                    // uint32_t texels
+#include <iostream>                   // Error reporting
+
+TextureAtlas::~TextureAtlas() {
+    for (auto& sprite : sprites) {
+        FreeImage(sprite.image);
+    }
+}
+
+void TextureAtlas::Add(const std::string& name, ImageData image) {
+    Sprite sprite;
+    sprite.name = name;
+    sprite.image = image;
+    sprites.push_back(sprite);
+}
+
+// Simple shelf packer: sprites sorted by height are laid left to right, starting a
+// new shelf when a row fills up. Returns the total height used, or -1 if a sprite
+// is wider than the atlas.
+int TextureAtlas::PackShelves(std::vector<Sprite*>& sorted, int width) {
+    int x = 0, y = 0, shelfHeight = 0;
+    for (Sprite* sprite : sorted) {
+        int w = sprite->image.width + 2 * PADDING;
+        int h = sprite->image.height + 2 * PADDING;
+        if (w > width) return -1;
+
+        if (x + w > width) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        sprite->x = x;
+        sprite->y = y;
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+    return y + shelfHeight;
+}
+
+bool TextureAtlas::Build(int maxSize) {
+    std::vector<Sprite*> sorted;
+    for (auto& sprite : sprites) {
+        if (sprite.image.pixels) sorted.push_back(&sprite);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Sprite* a, const Sprite* b) {
+        return a->image.height > b->image.height;
+    });
+
+    // Try a few widths and keep the one that wastes the least area
+    int bestWidth = 0, bestHeight = 0;
+    for (int w = 256; w <= maxSize; w += 128) {
+        int h = PackShelves(sorted, w);
+        if (h < 0 || h > maxSize) continue;
+        if (bestWidth == 0 || static_cast<long long>(w) * h < static_cast<long long>(bestWidth) * bestHeight) {
+            bestWidth = w;
+            bestHeight = h;
+        }
+    }
+    if (bestWidth == 0) {
+        std::cerr << "Sprites do not fit in a " << maxSize << "x" << maxSize << " atlas" << std::endl;
+        return false;
+    }
+    width = bestWidth;
+    height = std::max(bestHeight, 1);
+    PackShelves(sorted, width);
+
+    // Copy each sprite in, repeating its border texels into the padding
+    std::vector<uint32_t> texels(static_cast<size_t>(width) * height, 0);
+    for (const Sprite* sprite : sorted) {
+        const ImageData& img = sprite->image;
+        const uint32_t* src = reinterpret_cast<const uint32_t*>(img.pixels);
+        for (int row = -PADDING; row < img.height + PADDING; ++row) {
+            int srcRow = std::min(std::max(row, 0), img.height - 1);
+            uint32_t* dst = &texels[static_cast<size_t>(sprite->y + PADDING + row) * width + sprite->x + PADDING];
+            for (int col = -PADDING; col < img.width + PADDING; ++col) {
+                int srcCol = std::min(std::max(col, 0), img.width - 1);
+                dst[col] = src[static_cast<size_t>(srcRow) * img.width + srcCol];
+            }
+        }
+
+        UVRect uv;
+        uv.u0 = static_cast<float>(sprite->x + PADDING) / width;
+        uv.v0 = static_cast<float>(sprite->y + PADDING) / height;
+        uv.u1 = static_cast<float>(sprite->x + PADDING + img.width) / width;
+        uv.v1 = static_cast<float>(sprite->y + PADDING + img.height) / height;
+        uvs[sprite->name] = uv;
+    }
+
+    if (!texture) glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // The GPU copy is all we need from here on
+    for (auto& sprite : sprites) {
+        FreeImage(sprite.image);
+    }
+    sprites.clear();
+    return true;
+}
+
+void TextureAtlas::Release() {
+    if (texture) {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    uvs.clear();
+}
+
+UVRect TextureAtlas::Lookup(const std::string& name) const {
+    auto it = uvs.find(name);
+    if (it == uvs.end()) {
+        std::cerr << "Sprite not in atlas: " << name << std::endl;
+        return UVRect();
+    }
+    return it->second;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>                        // Name -> UV lookup table
+#include <string>                     // std::string sprite names
+#include <vector>                     // Pending sprite list
+
+#include <glew.h>                     // GLuint atlas texture
+
+#include "AssetLoader.h"             // ImageData
+#include "UVRect.h"                  // Lookup() results
+
+// Packs many small RGBA images into one GL texture so sprites can share a
+// single bind. Images are collected with Add() and packed/uploaded once by
+// Build(); after that, Lookup() returns the UV rectangle for each name.
+class TextureAtlas {
+public:
+    static const int PADDING = 2;     // Edge texels repeated around each sprite to avoid bleeding
+
+    ~TextureAtlas();
+
+    // Takes ownership of the decoded pixels
+    void Add(const std::string& name, ImageData image);
+    bool Build(int maxSize);
+    void Release();
+
+    GLuint Texture() const { return texture; }
+    UVRect Lookup(const std::string& name) const;
+
+private:
+    struct Sprite {
+        std::string name;
+        ImageData image;
+        int x = 0;
+        int y = 0;
+    };
+
+    static int PackShelves(std::vector<Sprite*>& sorted, int width);
+
+    std::vector<Sprite> sprites;
+    std::map<std::string, UVRect> uvs;
+    GLuint texture = 0;
+    int width = 0;
+    int height = 0;
+};
@@ -0,0 +1,345 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>                  // std::max
+#include <cstdlib>                    // malloc for ImageData pixels
+#include <iostream>                   // Error reporting
+
+#include "AssetPack.h"               // Cooked mip chains
+#include "stb_image.h"               // stbi_info for loose file sizes
+
+namespace {
+
+const double DROP_DELAY = 2.0;        // Seconds a coarser level must be enough before it replaces a finer one
+
+// 2x2 box filter. Odd edges repeat their last row/column. The pixels are
+// malloc'd, so FreeImage() releases them like stb_image's.
+bool HalveImage(const ImageData& src, ImageData& out) {
+    const int width = std::max(1, src.width / 2);
+    const int height = std::max(1, src.height / 2);
+    unsigned char* pixels = static_cast<unsigned char*>(malloc(static_cast<size_t>(width) * height * 4));
+    if (!pixels) return false;
+
+    for (int y = 0; y < height; ++y) {
+        const int y0 = std::min(y * 2, src.height - 1);
+        const int y1 = std::min(y * 2 + 1, src.height - 1);
+        for (int x = 0; x < width; ++x) {
+            const int x0 = std::min(x * 2, src.width - 1);
+            const int x1 = std::min(x * 2 + 1, src.width - 1);
+            const unsigned char* a = src.pixels + (static_cast<size_t>(y0) * src.width + x0) * 4;
+            const unsigned char* b = src.pixels + (static_cast<size_t>(y0) * src.width + x1) * 4;
+            const unsigned char* c = src.pixels + (static_cast<size_t>(y1) * src.width + x0) * 4;
+            const unsigned char* d = src.pixels + (static_cast<size_t>(y1) * src.width + x1) * 4;
+            unsigned char* dst = pixels + (static_cast<size_t>(y) * width + x) * 4;
+            for (int channel = 0; channel < 4; ++channel) {
+                dst[channel] = static_cast<unsigned char>((a[channel] + b[channel] + c[channel] + d[channel] + 2) / 4);
+            }
+        }
+    }
+
+    out.width = width;
+    out.height = height;
+    out.pixels = pixels;
+    return true;
+}
+
+// Decodes the file and keeps `level` and everything smaller
+bool DecodeLevels(const char* filepath, int level, std::vector<ImageData>& chain) {
+    ImageData image;
+    if (!DecodeImage(filepath, image)) return false;
+
+    for (int i = 0; ; ++i) {
+        if (i >= level) chain.push_back(image);
+        if (image.width == 1 && image.height == 1) break;
+
+        ImageData half;
+        const bool halved = HalveImage(image, half);
+        if (i < level) FreeImage(image);
+        if (!halved) {
+            for (auto& kept : chain) FreeImage(kept);
+            chain.clear();
+            std::cerr << "Out of memory downsampling: " << filepath << std::endl;
+            return false;
+        }
+        image = half;
+    }
+    return true;
+}
+
+void SetTextureParameters(int levels) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+} // namespace
+
+TextureStreamer::TextureStreamer() {
+    worker = std::thread(&TextureStreamer::WorkerLoop, this);
+}
+
+TextureStreamer::~TextureStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorker.notify_all();
+    worker.join();
+
+    for (auto& result : results) {
+        for (auto& image : result.chain) FreeImage(image);
+    }
+}
+
+// Source size and level count, without decoding anything
+bool TextureStreamer::Describe(Stream& stream) {
+    int width, height, channels;
+    if (stream.packed) {
+        width = static_cast<int>(stream.packed->width);
+        height = static_cast<int>(stream.packed->height);
+    }
+    else if (!stbi_info(stream.filepath.c_str(), &width, &height, &channels)) {
+        std::cerr << "Failed to load texture: " << stream.filepath << std::endl;
+        return false;
+    }
+
+    stream.width = static_cast<uint32_t>(width);
+    stream.height = static_cast<uint32_t>(height);
+    if (stream.packed) {
+        stream.levels = static_cast<int>(stream.packed->levels);
+    }
+    else {
+        stream.levels = 1;
+        while ((std::max(stream.width, stream.height) >> stream.levels) > 0) ++stream.levels;
+    }
+    return true;
+}
+
+int TextureStreamer::Add(const std::string& filepath, float coverageX, float coverageY) {
+    int handle = 0;
+    while (handle < static_cast<int>(streams.size()) && streams[handle].active) ++handle;
+    if (handle == static_cast<int>(streams.size())) streams.emplace_back();
+
+    Stream& stream = streams[handle];
+    const unsigned generation = stream.generation + 1;
+    stream = Stream();
+    stream.active = true;
+    stream.generation = generation;
+    stream.filepath = filepath;
+    stream.coverageX = coverageX;
+    stream.coverageY = coverageY;
+    if (pack) stream.packed = pack->Find(filepath, PackType::Texture);
+    stream.failed = !Describe(stream);
+    return handle;
+}
+
+void TextureStreamer::Reload(int handle) {
+    Stream& stream = streams[handle];
+    ++stream.generation;
+    stream.packed = nullptr;          // The pack holds the old contents
+    stream.requestedLevel = -1;
+    stream.coarserDue = false;
+    stream.failed = !Describe(stream);
+}
+
+void TextureStreamer::Remove(int handle) {
+    Stream& stream = streams[handle];
+    if (stream.texture) glDeleteTextures(1, &stream.texture);
+    const unsigned generation = stream.generation + 1;
+    stream = Stream();
+    stream.generation = generation;
+}
+
+void TextureStreamer::SetFramebufferSize(int width, int height) {
+    framebufferWidth = width;
+    framebufferHeight = height;
+}
+
+// The smallest level that still has a texel per pixel it's drawn over
+int TextureStreamer::WantedLevel(const Stream& stream) const {
+    const float drawnWidth = stream.coverageX * framebufferWidth;
+    const float drawnHeight = stream.coverageY * framebufferHeight;
+    int level = 0;
+    while (level + 1 < stream.levels
+        && PackLevelDimension(stream.width, level + 1) >= drawnWidth
+        && PackLevelDimension(stream.height, level + 1) >= drawnHeight) {
+        ++level;
+    }
+    return level;
+}
+
+void TextureStreamer::RequestLevel(int handle, int level) {
+    Stream& stream = streams[handle];
+    stream.requestedLevel = level;
+    loadedLastUpdate = true;
+
+    if (stream.packed) {
+        // Already on disk at every level; only the upload is left
+        const PackEntry& entry = *stream.packed;
+        const bool native = (entry.format == PackFormat::BC1 || entry.format == PackFormat::BC3)
+            && GLEW_EXT_texture_compression_s3tc;
+        size_t bytes = 0;
+        for (int i = level; i < static_cast<int>(entry.levels); ++i) {
+            const uint32_t w = PackLevelDimension(entry.width, i);
+            const uint32_t h = PackLevelDimension(entry.height, i);
+            bytes += native ? PackLevelSize(entry.format, w, h) : static_cast<size_t>(w) * h * 4;
+        }
+        Install(stream, pack->UploadTexture(entry, static_cast<uint32_t>(level)), level, bytes);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // A newer size replaces a request the worker hasn't started on yet
+        bool merged = false;
+        for (auto& request : requests) {
+            if (request.handle == handle) {
+                request.generation = stream.generation;
+                request.level = level;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            Request request;
+            request.handle = handle;
+            request.generation = stream.generation;
+            request.filepath = stream.filepath;
+            request.level = level;
+            requests.push_back(request);
+        }
+    }
+    wakeWorker.notify_one();
+}
+
+void TextureStreamer::Install(Stream& stream, GLuint texture, int level, size_t bytes) {
+    if (stream.texture) glDeleteTextures(1, &stream.texture);
+    stream.texture = texture;
+    stream.residentLevel = level;
+    stream.bytes = bytes;
+}
+
+bool TextureStreamer::Update(double budgetSeconds) {
+    const auto deadline = Clock::now() + std::chrono::duration<double>(budgetSeconds);
+    bool changed = false;
+    loadedLastUpdate = false;
+
+    for (;;) {
+        Result result;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (results.empty()) break;
+            result = std::move(results.front());
+            results.pop_front();
+        }
+
+        const bool current = result.handle < static_cast<int>(streams.size())
+            && streams[result.handle].active
+            && streams[result.handle].generation == result.generation
+            && streams[result.handle].requestedLevel == result.level;
+        if (current && result.chain.empty()) {
+            streams[result.handle].failed = true;
+        }
+        else if (current) {
+            GLuint texture;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            size_t bytes = 0;
+            for (size_t i = 0; i < result.chain.size(); ++i) {
+                const ImageData& image = result.chain[i];
+                glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), GL_RGBA, image.width, image.height, 0, GL_RGBA,
+                    GL_UNSIGNED_BYTE, image.pixels);
+                bytes += static_cast<size_t>(image.width) * image.height * 4;
+            }
+            SetTextureParameters(static_cast<int>(result.chain.size()));
+            Install(streams[result.handle], texture, result.level, bytes);
+            loadedLastUpdate = true;
+            changed = true;
+        }
+        for (auto& image : result.chain) FreeImage(image);
+
+        if (Clock::now() >= deadline) break;
+    }
+
+    const auto now = Clock::now();
+    const bool minimized = framebufferWidth <= 0 || framebufferHeight <= 0;
+    for (int handle = 0; handle < static_cast<int>(streams.size()); ++handle) {
+        Stream& stream = streams[handle];
+        if (!stream.active || stream.failed) continue;
+        // Nothing is visible while minimized; keep what's there for the restore
+        if (minimized && stream.requestedLevel >= 0) continue;
+
+        const int wanted = WantedLevel(stream);
+        if (wanted == stream.requestedLevel) {
+            stream.coarserDue = false;
+        }
+        else if (stream.requestedLevel < 0 || wanted < stream.requestedLevel) {
+            // More detail is needed right away
+            stream.coarserDue = false;
+            RequestLevel(handle, wanted);
+            changed |= stream.packed != nullptr;
+        }
+        else if (!stream.coarserDue) {
+            stream.coarserDue = true;
+            stream.coarserSince = now;
+        }
+        else if (std::chrono::duration<double>(now - stream.coarserSince).count() >= DROP_DELAY) {
+            stream.coarserDue = false;
+            RequestLevel(handle, wanted);
+            changed |= stream.packed != nullptr;
+        }
+    }
+    return changed;
+}
+
+bool TextureStreamer::Idle() const {
+    for (const auto& stream : streams) {
+        if (stream.active && !stream.failed && stream.residentLevel < 0) return false;
+    }
+    return true;
+}
+
+GLuint TextureStreamer::Texture(int handle) const {
+    if (handle < 0 || handle >= static_cast<int>(streams.size())) return 0;
+    return streams[handle].texture;
+}
+
+size_t TextureStreamer::ResidentBytes() const {
+    size_t bytes = 0;
+    for (const auto& stream : streams) {
+        if (stream.active) bytes += stream.bytes;
+    }
+    return bytes;
+}
+
+void TextureStreamer::Release() {
+    for (int handle = 0; handle < static_cast<int>(streams.size()); ++handle) {
+        if (streams[handle].active) Remove(handle);
+    }
+}
+
+void TextureStreamer::WorkerLoop() {
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorker.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            request = requests.front();
+            requests.pop_front();
+        }
+
+        Result result;
+        result.handle = request.handle;
+        result.generation = request.generation;
+        result.level = request.level;
+        DecodeLevels(request.filepath.c_str(), request.level, result.chain);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(std::move(result));
+        }
+        if (wake) wake();
+    }
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>                     // Drop delay
+#include <condition_variable>         // Wakes the decode thread
+#include <cstddef>                    // size_t
+#include <cstdint>                    // uint32_t sizes
+#include <deque>                      // Decode requests and results
+#include <mutex>                      // Guards the queues
+#include <string>                     // std::string paths
+#include <thread>                     // Decode thread
+#include <vector>                     // Streams, mip chains
+
+#include <glew.h>                     // GLuint textures
+
+#include "AssetLoader.h"             // ImageData, DecodeImage
+
+class AssetPack;
+struct PackEntry;
+
+// Keeps big, full-screen textures (the background and soundboard) resident
+// only at the mip level the framebuffer can show. Each texture says how much
+// of the framebuffer it covers; the streamer picks the smallest source level
+// that is still at least that many pixels, and uploads that level and the
+// ones below it as a new texture. When the window grows, the finer level is
+// loaded and swapped in; when it shrinks, the coarser one replaces it after
+// a couple of seconds, so dragging the window edge doesn't reload on every frame.
+//
+// Cooked textures upload straight from the pack mapping on the main thread.
+// Loose files are decoded and downsampled on a worker thread, and read from
+// disk again whenever a level is needed, so nothing larger than the resident
+// level is kept in memory.
+class TextureStreamer {
+public:
+    TextureStreamer();
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Cooked textures found here skip decoding; the pack must outlive the streamer
+    void UsePack(const AssetPack* assetPack) { pack = assetPack; }
+    // Called from the decode thread when a level is ready, e.g. glfwPostEmptyEvent
+    void SetWakeCallback(void (*callback)()) { wake = callback; }
+
+    // `coverageX`/`coverageY` are the fraction of the framebuffer's width and
+    // height the texture is drawn over. Returns a handle; the texture appears
+    // once its first level is uploaded.
+    int Add(const std::string& filepath, float coverageX, float coverageY);
+    // The file changed on disk; loads it again from the loose file
+    void Reload(int handle);
+    void Remove(int handle);
+
+    void SetFramebufferSize(int width, int height);
+
+    // Main thread. Requests the levels the current framebuffer needs and
+    // uploads what's ready within the budget. Returns true if a texture changed.
+    bool Update(double budgetSeconds);
+    // True if the last Update() requested or uploaded a level. Those frames
+    // allocate (request copies, GL uploads), unlike steady ones.
+    bool LoadedLastUpdate() const { return loadedLastUpdate; }
+
+    // True once every texture has a level uploaded (or failed to load)
+    bool Idle() const;
+
+    GLuint Texture(int handle) const;
+    // GPU memory held by the resident levels, mip chains included
+    size_t ResidentBytes() const;
+
+    // Deletes every texture; the GL context must still be current
+    void Release();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stream {
+        bool active = false;
+        std::string filepath;
+        const PackEntry* packed = nullptr;
+        float coverageX = 1.0f;
+        float coverageY = 1.0f;
+        uint32_t width = 0;           // Source level 0
+        uint32_t height = 0;
+        int levels = 0;               // Mip levels the source can provide
+        GLuint texture = 0;
+        int residentLevel = -1;       // Source level that is `texture`'s level 0
+        int requestedLevel = -1;
+        size_t bytes = 0;
+        unsigned generation = 0;      // Results from before a Reload/Remove are dropped
+        bool failed = false;
+        bool coarserDue = false;      // A coarser level is enough; waiting out the drop delay
+        Clock::time_point coarserSince;
+    };
+
+    struct Request {
+        int handle = -1;
+        unsigned generation = 0;
+        std::string filepath;
+        int level = 0;
+    };
+
+    struct Result {
+        int handle = -1;
+        unsigned generation = 0;
+        int level = 0;
+        std::vector<ImageData> chain;  // Level `level` first, down to 1x1; empty on failure
+    };
+
+    bool Describe(Stream& stream);
+    int WantedLevel(const Stream& stream) const;
+    void RequestLevel(int handle, int level);
+    void Install(Stream& stream, GLuint texture, int level, size_t bytes);
+    void WorkerLoop();
+
+    const AssetPack* pack = nullptr;
+    void (*wake)() = nullptr;
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    std::vector<Stream> streams;      // Main thread only
+    bool loadedLastUpdate = false;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    std::deque<Request> requests;
+    std::deque<Result> results;
+    bool stopping = false;
+};
@@ -0,0 +1,75 @@
+#include "Tween.h"
+
+float Eased(Ease ease, float t) {
+    switch (ease) {
+    case Ease::Linear:
+        return t;
+    case Ease::QuadIn:
+        return t * t;
+    case Ease::QuadOut:
+        return 1.0f - (1.0f - t) * (1.0f - t);
+    case Ease::QuadInOut:
+        return t < 0.5f ? 2.0f * t * t : 1.0f - 2.0f * (1.0f - t) * (1.0f - t);
+    case Ease::CubicOut: {
+        const float u = 1.0f - t;
+        return 1.0f - u * u * u;
+    }
+    case Ease::BackOut: {
+        const float overshoot = 1.70158f;
+        const float u = t - 1.0f;
+        return 1.0f + (overshoot + 1.0f) * u * u * u + overshoot * u * u;
+    }
+    }
+    return t;
+}
+
+void TweenList::Start(const Tween& tween) {
+    for (auto& running : tweens) {
+        if (running.value == tween.value) {
+            running = tween;
+            return;
+        }
+    }
+    tweens.push_back(tween);
+}
+
+void TweenList::Stop(const float* value) {
+    for (size_t i = 0; i < tweens.size(); ++i) {
+        if (tweens[i].value == value) {
+            tweens[i] = tweens.back();
+            tweens.pop_back();
+            return;
+        }
+    }
+}
+
+bool TweenList::Running(const float* value) const {
+    for (const auto& tween : tweens) {
+        if (tween.value == value) return true;
+    }
+    return false;
+}
+
+void TweenList::Update(float deltaTime, std::vector<int>& finished) {
+    for (size_t i = 0; i < tweens.size();) {
+        Tween& tween = tweens[i];
+        if (tween.previous) *tween.previous = *tween.value;
+        tween.elapsed += deltaTime;
+
+        if (tween.elapsed >= tween.duration) {
+            // Snaps the previous value too; it's within a step of the end anyway
+            const float end = tween.yoyo ? tween.from : tween.to;
+            *tween.value = end;
+            if (tween.previous) *tween.previous = end;
+            finished.push_back(tween.tag);
+            tweens[i] = tweens.back();
+            tweens.pop_back();
+            continue;
+        }
+
+        float t = tween.elapsed / tween.duration;
+        if (tween.yoyo) t = t < 0.5f ? t * 2 : (1.0f - t) * 2;
+        *tween.value = tween.from + (tween.to - tween.from) * Eased(tween.ease, t);
+        ++i;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <cstdint>                    // uint8_t easing ids
+#include <vector>                     // Active tweens
+
+enum class Ease : uint8_t {
+    Linear,
+    QuadIn,
+    QuadOut,
+    QuadInOut,
+    CubicOut,
+    BackOut,                          // Overshoots the end a little, then settles
+};
+
+// Maps linear progress in [0, 1] onto the curve
+float Eased(Ease ease, float t);
+
+// Animates one float from `from` to `to`. The value is owned by someone else
+// and must stay at the same address while the tween runs.
+struct Tween {
+    float* value = nullptr;
+    float* previous = nullptr;        // Gets `*value` from before each step, for drawing between steps; may be null
+    float from = 0.0f;
+    float to = 1.0f;
+    float duration = 0.0f;
+    float elapsed = 0.0f;
+    Ease ease = Ease::Linear;
+    bool yoyo = false;                // Out to `to` over the first half, back to `from` over the second
+    int tag = -1;                     // The owner's id, reported when the tween finishes
+};
+
+// The running tweens, packed in one array with nothing else in between, so a
+// step costs one pass over what is actually moving rather than over every
+// entity that could. Finished tweens land exactly on their end value and are
+// swapped out with the last one.
+class TweenList {
+public:
+    // Replaces a tween already running on the same value
+    void Start(const Tween& tween);
+    // Leaves the value where it is
+    void Stop(const float* value);
+    void Clear() { tweens.clear(); }
+    // Room for this many at once, so Start() never allocates mid-game
+    void Reserve(size_t count) { tweens.reserve(count); }
+
+    // Advances every tween. Tags of the ones that finished are appended to `finished`.
+    void Update(float deltaTime, std::vector<int>& finished);
+
+    bool Empty() const { return tweens.empty(); }
+    size_t Count() const { return tweens.size(); }
+    bool Running(const float* value) const;
+    const std::vector<Tween>& Active() const { return tweens; }
+
+private:
+    std::vector<Tween> tweens;
+};
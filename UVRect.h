@@ -0,0 +1,10 @@
+#pragma once
+
+// Texture coordinates of one sprite inside the atlas. v0 is the top row of
+// the image, matching how the draw code maps (0,0) to the top-left corner.
+struct UVRect {
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+};
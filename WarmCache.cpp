@@ -0,0 +1,233 @@
+#include "WarmCache.h"
+
+#include <cstdlib>                    // getenv, malloc
+#include <cstring>                    // memcmp, memcpy
+#include <functional>                 // std::hash of the thread id
+#include <iostream>                   // Error reporting
+#include <sstream>                    // Entry names
+#include <thread>                     // Per-thread temporary names
+
+#include "AssetLoader.h"             // ImageData
+#include "AudioDecoder.h"            // DecodedAudio
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>                  // CreateDirectoryA
+#else
+#include <cerrno>                     // EEXIST
+#include <sys/stat.h>                 // mkdir
+#endif
+
+namespace {
+
+const char MAGIC[4] = { 'M', 'W', 'W', 'C' };
+const uint32_t KIND_IMAGE = 1;
+const uint32_t KIND_SOUND = 2;
+const uint32_t KIND_PROGRAM = 3;
+
+const WarmCache* activeCache = nullptr;
+
+bool MakeDirectory(const std::string& path) {
+#ifdef _WIN32
+    return CreateDirectoryA(path.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+// Creates every missing directory along the path
+bool MakeDirectories(const std::string& path) {
+    for (size_t slash = path.find_first_of("/\\", 1); slash != std::string::npos;
+        slash = path.find_first_of("/\\", slash + 1)) {
+        MakeDirectory(path.substr(0, slash));
+    }
+    return MakeDirectory(path);
+}
+
+const char* KindExtension(uint32_t kind) {
+    switch (kind) {
+    case KIND_IMAGE: return ".rgba";
+    case KIND_SOUND: return ".pcm";
+    default: return ".prog";
+    }
+}
+
+} // namespace
+
+void SetWarmCache(const WarmCache* cache) {
+    activeCache = cache;
+}
+
+const WarmCache* GetWarmCache() {
+    return activeCache;
+}
+
+std::string WarmCache::DefaultDirectory() {
+#ifdef _WIN32
+    const char* base = std::getenv("LOCALAPPDATA");
+    return base ? std::string(base) + "\\MooWho\\WarmCache" : std::string();
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) return std::string(xdg) + "/moowho";
+    const char* home = std::getenv("HOME");
+    return home ? std::string(home) + "/.cache/moowho" : std::string();
+#endif
+}
+
+bool WarmCache::Open(const std::string& cacheDirectory) {
+    directory.clear();
+    if (cacheDirectory.empty() || !MakeDirectories(cacheDirectory)) {
+        std::cerr << "Warm-start cache unavailable: " << cacheDirectory << std::endl;
+        return false;
+    }
+    directory = cacheDirectory;
+    return true;
+}
+
+// FNV-1a over 8-byte words, then the tail bytes; the size goes in too
+uint64_t WarmCache::Hash(const void* data, size_t size, uint64_t seed) {
+    const uint64_t prime = 1099511628211ull;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * prime;
+    }
+    return (hash ^ static_cast<uint64_t>(size)) * prime;
+}
+
+std::string WarmCache::EntryPath(uint64_t key, uint32_t kind) const {
+    std::ostringstream name;
+    name << directory << "/" << std::hex;
+    name.width(16);
+    name.fill('0');
+    name << key << KindExtension(kind);
+    return name.str();
+}
+
+FILE* WarmCache::OpenEntry(uint64_t key, uint32_t kind, Header& header) const {
+    if (!IsOpen()) return nullptr;
+
+    FILE* file = fopen(EntryPath(key, kind).c_str(), "rb");
+    if (!file) return nullptr;
+
+    // The payload must be exactly what's left, so a truncated or foreign file never gets trusted
+    bool valid = fseek(file, 0, SEEK_END) == 0;
+    const long fileSize = valid ? ftell(file) : -1;
+    valid = valid && fileSize >= static_cast<long>(sizeof(header)) && fseek(file, 0, SEEK_SET) == 0
+        && fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.kind == kind && header.key == key
+        && header.payloadSize == static_cast<uint64_t>(fileSize) - sizeof(header);
+    if (!valid) {
+        fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+void WarmCache::Store(uint64_t key, uint32_t kind, const uint32_t params[3], const void* payload, size_t size) const {
+    if (!IsOpen()) return;
+
+    Header header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.kind = kind;
+    header.key = key;
+    memcpy(header.params, params, sizeof(header.params));
+    header.payloadSize = size;
+
+    const std::string path = EntryPath(key, kind);
+    std::ostringstream temp;
+    temp << path << ".tmp" << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+    FILE* file = fopen(temp.str().c_str(), "wb");
+    if (!file) return;
+    const bool written = fwrite(&header, sizeof(header), 1, file) == 1
+        && (size == 0 || fwrite(payload, size, 1, file) == 1);
+    const bool closed = fclose(file) == 0;
+    if (!written || !closed) {
+        remove(temp.str().c_str());
+        return;
+    }
+
+    // Windows won't rename over an existing file
+    remove(path.c_str());
+    if (rename(temp.str().c_str(), path.c_str()) != 0) remove(temp.str().c_str());
+}
+
+bool WarmCache::LoadDecodedImage(uint64_t key, ImageData& out) const {
+    Header header;
+    FILE* file = OpenEntry(key, KIND_IMAGE, header);
+    if (!file) return false;
+
+    const uint64_t expected = static_cast<uint64_t>(header.params[0]) * header.params[1] * 4;
+    unsigned char* pixels = nullptr;
+    if (header.params[0] > 0 && header.params[1] > 0 && header.payloadSize == expected) {
+        pixels = static_cast<unsigned char*>(malloc(static_cast<size_t>(expected)));
+    }
+    const bool ok = pixels && fread(pixels, static_cast<size_t>(expected), 1, file) == 1;
+    fclose(file);
+    if (!ok) {
+        free(pixels);
+        return false;
+    }
+
+    out.width = static_cast<int>(header.params[0]);
+    out.height = static_cast<int>(header.params[1]);
+    out.pixels = pixels;
+    return true;
+}
+
+void WarmCache::StoreDecodedImage(uint64_t key, const ImageData& image) const {
+    const uint32_t params[3] = { static_cast<uint32_t>(image.width), static_cast<uint32_t>(image.height), 0 };
+    Store(key, KIND_IMAGE, params, image.pixels, static_cast<size_t>(image.width) * image.height * 4);
+}
+
+bool WarmCache::LoadDecodedSound(uint64_t key, DecodedAudio& out) const {
+    Header header;
+    FILE* file = OpenEntry(key, KIND_SOUND, header);
+    if (!file) return false;
+
+    bool ok = header.params[0] > 0 && header.params[1] > 0 && header.payloadSize % sizeof(int16_t) == 0;
+    if (ok) {
+        out.samples.resize(static_cast<size_t>(header.payloadSize / sizeof(int16_t)));
+        ok = out.samples.empty() || fread(out.samples.data(), static_cast<size_t>(header.payloadSize), 1, file) == 1;
+    }
+    fclose(file);
+    if (!ok) {
+        out.samples.clear();
+        return false;
+    }
+
+    out.channels = header.params[0];
+    out.sampleRate = header.params[1];
+    return true;
+}
+
+void WarmCache::StoreDecodedSound(uint64_t key, const DecodedAudio& audio) const {
+    const uint32_t params[3] = { audio.channels, audio.sampleRate, 0 };
+    Store(key, KIND_SOUND, params, audio.samples.data(), audio.samples.size() * sizeof(int16_t));
+}
+
+bool WarmCache::LoadProgram(uint64_t key, uint32_t& format, std::vector<unsigned char>& binary) const {
+    Header header;
+    FILE* file = OpenEntry(key, KIND_PROGRAM, header);
+    if (!file) return false;
+
+    binary.resize(static_cast<size_t>(header.payloadSize));
+    const bool ok = !binary.empty() && fread(binary.data(), binary.size(), 1, file) == 1;
+    fclose(file);
+    if (!ok) return false;
+
+    format = header.params[0];
+    return true;
+}
+
+void WarmCache::StoreProgram(uint64_t key, uint32_t format, const void* binary, size_t size) const {
+    const uint32_t params[3] = { format, 0, 0 };
+    Store(key, KIND_PROGRAM, params, binary, size);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+#include <cstdint>                    // Content hashes
+#include <cstdio>                     // FILE entries
+#include <string>                     // Directory path
+#include <vector>                     // Program binaries
+
+struct DecodedAudio;
+struct ImageData;
+
+// Results of the slow startup work, kept on disk under the user profile so
+// the next launch can skip it: decoded RGBA for loose images, PCM for
+// MP3/FLAC sounds, and linked shader program binaries. Each entry is named
+// after a hash of everything it was made from (the source file's bytes, or
+// the shader sources plus the GL driver's identity), and the hash is checked
+// again when the entry is read. An edited asset or a driver update simply
+// misses and takes the slow path, which writes a fresh entry.
+//
+// Lookups and stores are safe from any thread. Stores write a temporary file
+// and rename it into place, so a crash never leaves a half-written entry.
+// Entries made from an older version of a file stay behind until the
+// directory is deleted.
+class WarmCache {
+public:
+    // %LOCALAPPDATA%\MooWho\WarmCache on Windows, $XDG_CACHE_HOME/moowho (or
+    // ~/.cache/moowho) elsewhere. Empty if none of those are set.
+    static std::string DefaultDirectory();
+
+    // Creates the directory if needed. Returns false if it can't, and the
+    // cache stays closed.
+    bool Open(const std::string& cacheDirectory);
+    bool IsOpen() const { return !directory.empty(); }
+
+    // Hashes file contents or sources for the keys below; chain calls
+    // by passing the previous result as the seed
+    static uint64_t Hash(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+    // Not LoadImage: <windows.h> defines that as a macro and would rename it.
+    // Pixels are malloc'd, so FreeImage() releases them like stb_image's.
+    bool LoadDecodedImage(uint64_t key, ImageData& out) const;
+    void StoreDecodedImage(uint64_t key, const ImageData& image) const;
+
+    bool LoadDecodedSound(uint64_t key, DecodedAudio& out) const;
+    void StoreDecodedSound(uint64_t key, const DecodedAudio& audio) const;
+
+    // `format` is the driver's binary format from glGetProgramBinary
+    bool LoadProgram(uint64_t key, uint32_t& format, std::vector<unsigned char>& binary) const;
+    void StoreProgram(uint64_t key, uint32_t format, const void* binary, size_t size) const;
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t kind;
+        uint64_t key;
+        uint32_t params[3];           // Width/height, channels/rate or program format
+        uint32_t reserved;
+        uint64_t payloadSize;
+    };
+
+    std::string EntryPath(uint64_t key, uint32_t kind) const;
+    // Fills `header` and opens the entry positioned at its payload; null on any mismatch
+    FILE* OpenEntry(uint64_t key, uint32_t kind, Header& header) const;
+    void Store(uint64_t key, uint32_t kind, const uint32_t params[3], const void* payload, size_t size) const;
+
+    std::string directory;
+};
+
+// The cache the asset decoders and shader builder use. Set it at startup,
+// before anything loads; null (the default) disables it.
+void SetWarmCache(const WarmCache* cache);
+const WarmCache* GetWarmCache();
@@ -0,0 +1,88 @@
+#include "WavFile.h"
+
+#include <cstdint>                    // Fixed-width integer types
+#include <cstring>                    // memcmp, memcpy
+#include <iostream>                   // Error reporting
+
+namespace {
+
+const uint16_t FORMAT_PCM = 1;
+const uint16_t FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint32_t ReadU32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint16_t ReadU16(const unsigned char* p) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+bool ParseWavChunks(const unsigned char* bytes, size_t size, WavInfo& out, const char* filepath) {
+    if (size < 12 || memcmp(bytes, "RIFF", 4) != 0 || memcmp(bytes + 8, "WAVE", 4) != 0) {
+        std::cerr << "Not a RIFF/WAVE file: " << filepath << std::endl;
+        return false;
+    }
+
+    bool haveFormat = false;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const unsigned char* chunk = bytes + offset;
+        const size_t chunkSize = ReadU32(chunk + 4);
+        const size_t available = size - offset - 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || chunkSize > available) {
+                std::cerr << "Truncated fmt chunk: " << filepath << std::endl;
+                return false;
+            }
+            uint16_t audioFormat = ReadU16(chunk + 8);
+            if (audioFormat == FORMAT_EXTENSIBLE && chunkSize >= 40) {
+                audioFormat = ReadU16(chunk + 8 + 24);  // First two bytes of the SubFormat GUID
+            }
+            if (audioFormat != FORMAT_PCM) {
+                std::cerr << "Only PCM format supported: " << filepath << std::endl;
+                return false;
+            }
+            out.channels = ReadU16(chunk + 10);
+            out.sampleRate = ReadU32(chunk + 12);
+            out.blockAlign = ReadU16(chunk + 20);
+            out.bitsPerSample = ReadU16(chunk + 22);
+            haveFormat = true;
+        }
+        else if (memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) {
+                std::cerr << "data chunk before fmt chunk: " << filepath << std::endl;
+                return false;
+            }
+            // Streamed writers sometimes leave the size at 0 or 0xFFFFFFFF; take what's there
+            out.data = chunk + 8;
+            out.dataSize = (chunkSize == 0 || chunkSize > available) ? available : chunkSize;
+            if (out.blockAlign) out.dataSize -= out.dataSize % out.blockAlign;
+            break;
+        }
+
+        // Chunks are padded to an even size
+        if (chunkSize >= available) break;
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (!out.data) {
+        std::cerr << "No data chunk in WAV file: " << filepath << std::endl;
+        return false;
+    }
+    if (out.channels < 1 || out.channels > 2) {
+        std::cerr << "Unsupported number of channels: " << out.channels << std::endl;
+        return false;
+    }
+    if (out.bitsPerSample != 8 && out.bitsPerSample != 16) {
+        std::cerr << "Unsupported bits per sample: " << out.bitsPerSample << std::endl;
+        return false;
+    }
+    return true;
+}
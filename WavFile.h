@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>                    // size_t
+
+// Format and sample data of a PCM WAV file that is already in memory.
+// `data` points into the caller's buffer; nothing is copied.
+struct WavInfo {
+    unsigned short channels = 0;
+    unsigned short bitsPerSample = 0;
+    unsigned short blockAlign = 0;
+    unsigned sampleRate = 0;
+    const unsigned char* data = nullptr;
+    size_t dataSize = 0;
+};
+
+// Walks the RIFF chunk list, so files with LIST, fact, cue or other chunks
+// before (or after) the sample data work too. Accepts 8/16-bit mono/stereo
+// PCM, including WAVE_FORMAT_EXTENSIBLE headers that wrap it.
+bool ParseWavChunks(const unsigned char* bytes, size_t size, WavInfo& out, const char* filepath);
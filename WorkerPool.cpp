@@ -0,0 +1,77 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores - 1 : 1;
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::RunIndices(const std::function<void(int)>& body, int count) {
+    for (int i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1)) {
+        body(i);
+    }
+}
+
+void WorkerPool::ParallelFor(int count, const std::function<void(int)>& body) {
+    if (count <= 0) return;
+    if (count == 1 || workers.empty()) {
+        for (int i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batchBody = &body;
+        batchCount = count;
+        nextIndex.store(0);
+        ++batch;
+    }
+    start.notify_all();
+
+    RunIndices(body, count);
+
+    // Every index has been handed out; wait for the ones still running
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy == 0; });
+    batchBody = nullptr;
+}
+
+void WorkerPool::WorkerLoop() {
+    unsigned long long seen = 0;
+    for (;;) {
+        const std::function<void(int)>* body;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            start.wait(lock, [&] { return stopping || (batch != seen && batchBody); });
+            if (stopping) return;
+            seen = batch;
+            body = batchBody;
+            count = batchCount;
+            ++busy;
+        }
+
+        RunIndices(*body, count);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy;
+        }
+        finished.notify_one();
+    }
+}
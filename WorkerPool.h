@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>                     // Next index to hand out
+#include <condition_variable>         // Start and finish signals
+#include <functional>                 // Loop bodies
+#include <mutex>                      // Guards the batch state
+#include <thread>                     // Worker threads
+#include <vector>                     // Workers
+
+// A fixed set of threads for splitting one loop across cores, e.g. updating
+// every game session in a frame. The calling thread works on the loop too,
+// and ParallelFor() only returns once every index has run. Only one thread
+// may call ParallelFor() at a time.
+class WorkerPool {
+public:
+    // 0 picks one thread per core, minus the caller's
+    explicit WorkerPool(unsigned threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Runs body(0) .. body(count - 1), in no particular order or thread
+    void ParallelFor(int count, const std::function<void(int)>& body);
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    void WorkerLoop();
+    void RunIndices(const std::function<void(int)>& body, int count);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable finished;
+    const std::function<void(int)>* batchBody = nullptr;
+    int batchCount = 0;
+    unsigned long long batch = 0;     // Bumped for every ParallelFor()
+    int busy = 0;                     // Workers still inside the current batch
+    std::atomic<int> nextIndex{ 0 };
+    bool stopping = false;
+};
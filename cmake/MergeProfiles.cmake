@@ -0,0 +1,14 @@
+# Merges the raw profiles an instrumented Clang build wrote into the one file
+# -fprofile-use reads. Run by the pgo-train target:
+#   cmake -DPROFDATA_TOOL=llvm-profdata -DPROFILE_DIR=dir -DOUTPUT=file -P MergeProfiles.cmake
+file(GLOB rawProfiles "${PROFILE_DIR}/*.profraw")
+if(NOT rawProfiles)
+    message(FATAL_ERROR "No .profraw files in ${PROFILE_DIR}; did the instrumented replay run?")
+endif()
+
+execute_process(COMMAND ${PROFDATA_TOOL} merge -output=${OUTPUT} ${rawProfiles} RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge failed")
+endif()
+# Stale raw profiles would be merged again into the next training run
+file(REMOVE ${rawProfiles})
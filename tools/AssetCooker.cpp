@@ -0,0 +1,315 @@
+// Offline cooker for assets.pak. Reads a manifest of textures, sprites and
+// sounds, and writes them in the layout described in PackFormat.h:
+//   - textures are shrunk to fit --max-size, mipmapped and BC1/BC3 compressed
+//     (or left as RGBA8 with --rgba, for GPUs without S3TC)
+//   - sprites are stored as plain RGBA8, since the game repacks them into its atlas
+//   - sounds are stored as raw PCM: the WAV data chunk, or 16-bit samples
+//     decoded from MP3/FLAC
+//
+// Usage: AssetCooker <manifest> <output.pak> [--rgba] [--max-size N]
+// Run from the game's working directory so manifest paths match the ones the game loads.
+
+#include <algorithm>                  // std::max, std::min
+#include <cstdint>                    // Fixed-width integer types
+#include <cstdlib>                    // atoi
+#include <cstring>                    // memcpy, strncpy
+#include <fstream>                    // Manifest input, pack output
+#include <iostream>                   // Progress and error reporting
+#include <sstream>                    // Manifest line parsing
+#include <string>                     // std::string paths
+#include <vector>                     // Blob staging
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"               // STB image loader
+
+#include "AudioDecoder.h"            // MP3/FLAC sounds
+#include "BlockCompression.h"        // BC1/BC3 encoders
+#include "MappedFile.h"              // WAV input
+#include "PackFormat.h"              // On-disk layout
+#include "WavFile.h"                 // RIFF chunk walk
+
+namespace {
+
+struct CookedAsset {
+    PackEntry entry;
+    std::vector<unsigned char> blob;
+};
+
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels;  // RGBA8
+};
+
+bool LoadImage(const std::string& path, Image& out) {
+    int channels;
+    unsigned char* pixels = stbi_load(path.c_str(), &out.width, &out.height, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        std::cerr << "Failed to load image: " << path << std::endl;
+        return false;
+    }
+    out.pixels.assign(pixels, pixels + static_cast<size_t>(out.width) * out.height * 4);
+    stbi_image_free(pixels);
+    return true;
+}
+
+// Box-filters the image down to width x height. Colors are weighted by alpha
+// so transparent texels don't darken the edges of cut-out sprites.
+Image Downsample(const Image& src, int width, int height) {
+    Image dst;
+    dst.width = width;
+    dst.height = height;
+    dst.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    const double scaleX = static_cast<double>(src.width) / width;
+    const double scaleY = static_cast<double>(src.height) / height;
+    for (int y = 0; y < height; ++y) {
+        const int y0 = static_cast<int>(y * scaleY);
+        const int y1 = std::max(y0 + 1, std::min(src.height, static_cast<int>((y + 1) * scaleY)));
+        for (int x = 0; x < width; ++x) {
+            const int x0 = static_cast<int>(x * scaleX);
+            const int x1 = std::max(x0 + 1, std::min(src.width, static_cast<int>((x + 1) * scaleX)));
+
+            double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+            int count = 0;
+            for (int sy = y0; sy < y1; ++sy) {
+                for (int sx = x0; sx < x1; ++sx) {
+                    const unsigned char* p = &src.pixels[(static_cast<size_t>(sy) * src.width + sx) * 4];
+                    const double alpha = p[3] / 255.0;
+                    sum[0] += p[0] * alpha;
+                    sum[1] += p[1] * alpha;
+                    sum[2] += p[2] * alpha;
+                    sum[3] += p[3];
+                    ++count;
+                }
+            }
+
+            unsigned char* out = &dst.pixels[(static_cast<size_t>(y) * width + x) * 4];
+            const double alphaSum = sum[3] / 255.0;
+            for (int c = 0; c < 3; ++c) {
+                out[c] = static_cast<unsigned char>(alphaSum > 0.0 ? std::min(255.0, sum[c] / alphaSum + 0.5) : 0.0);
+            }
+            out[3] = static_cast<unsigned char>(sum[3] / count + 0.5);
+        }
+    }
+    return dst;
+}
+
+bool HasAlpha(const Image& image) {
+    for (size_t i = 3; i < image.pixels.size(); i += 4) {
+        if (image.pixels[i] != 255) return true;
+    }
+    return false;
+}
+
+void SetName(PackEntry& entry, const std::string& name) {
+    strncpy(entry.name, name.c_str(), PACK_NAME_LENGTH - 1);
+    entry.name[PACK_NAME_LENGTH - 1] = '\0';
+}
+
+bool CookTexture(const std::string& path, bool rgba, int maxSize, CookedAsset& out) {
+    Image image;
+    if (!LoadImage(path, image)) return false;
+
+    // Shrink to fit, keeping the aspect ratio
+    const int longest = std::max(image.width, image.height);
+    if (longest > maxSize) {
+        const double scale = static_cast<double>(maxSize) / longest;
+        image = Downsample(image, std::max(1, static_cast<int>(image.width * scale + 0.5)),
+            std::max(1, static_cast<int>(image.height * scale + 0.5)));
+    }
+
+    PackEntry& entry = out.entry;
+    entry.type = PackType::Texture;
+    entry.format = rgba ? PackFormat::RGBA8 : (HasAlpha(image) ? PackFormat::BC3 : PackFormat::BC1);
+    entry.width = image.width;
+    entry.height = image.height;
+    entry.levels = 0;
+
+    std::vector<unsigned char> level;
+    for (;;) {
+        if (entry.format == PackFormat::BC1) CompressBC1(image.pixels.data(), image.width, image.height, level);
+        else if (entry.format == PackFormat::BC3) CompressBC3(image.pixels.data(), image.width, image.height, level);
+        else level = image.pixels;
+        out.blob.insert(out.blob.end(), level.begin(), level.end());
+        ++entry.levels;
+
+        if (image.width == 1 && image.height == 1) break;
+        image = Downsample(image, std::max(1, image.width / 2), std::max(1, image.height / 2));
+    }
+    return true;
+}
+
+bool CookSprite(const std::string& path, CookedAsset& out) {
+    Image image;
+    if (!LoadImage(path, image)) return false;
+
+    PackEntry& entry = out.entry;
+    entry.type = PackType::Sprite;
+    entry.format = PackFormat::RGBA8;
+    entry.width = image.width;
+    entry.height = image.height;
+    entry.levels = 1;
+    out.blob = std::move(image.pixels);
+    return true;
+}
+
+bool CookSound(const std::string& path, CookedAsset& out) {
+    MappedFile file;
+    if (!file.Open(path.c_str())) return false;
+
+    PackEntry& entry = out.entry;
+    entry.type = PackType::Sound;
+    entry.format = PackFormat::None;
+
+    if (IsCompressedAudio(path)) {
+        DecodedAudio decoded;
+        if (!DecodeAudio(file.Data(), file.Size(), decoded, path.c_str())) return false;
+
+        entry.channels = decoded.channels;
+        entry.bitsPerSample = 16;
+        entry.sampleRate = decoded.sampleRate;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(decoded.samples.data());
+        out.blob.assign(bytes, bytes + decoded.samples.size() * sizeof(int16_t));
+        return true;
+    }
+
+    WavInfo wav;
+    if (!ParseWavChunks(file.Data(), file.Size(), wav, path.c_str())) return false;
+
+    entry.channels = wav.channels;
+    entry.bitsPerSample = wav.bitsPerSample;
+    entry.sampleRate = wav.sampleRate;
+    out.blob.assign(wav.data, wav.data + wav.dataSize);
+    return true;
+}
+
+size_t Align(size_t offset) {
+    return (offset + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+}
+
+bool WritePack(const char* filepath, std::vector<CookedAsset>& assets) {
+    size_t offset = Align(sizeof(PackHeader) + assets.size() * sizeof(PackEntry));
+    for (auto& asset : assets) {
+        asset.entry.offset = offset;
+        asset.entry.size = asset.blob.size();
+        offset = Align(offset + asset.blob.size());
+    }
+
+    std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to create pack: " << filepath << std::endl;
+        return false;
+    }
+
+    PackHeader header = {};
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entryCount = static_cast<uint32_t>(assets.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& asset : assets) {
+        out.write(reinterpret_cast<const char*>(&asset.entry), sizeof(PackEntry));
+    }
+
+    const char padding[PACK_ALIGNMENT] = {};
+    for (const auto& asset : assets) {
+        const size_t position = static_cast<size_t>(out.tellp());
+        out.write(padding, asset.entry.offset - position);
+        out.write(reinterpret_cast<const char*>(asset.blob.data()), asset.blob.size());
+    }
+    if (!out) {
+        std::cerr << "Failed to write pack: " << filepath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+const char* FormatName(PackFormat format) {
+    switch (format) {
+    case PackFormat::RGBA8: return "RGBA8";
+    case PackFormat::BC1: return "BC1";
+    case PackFormat::BC3: return "BC3";
+    default: return "PCM";
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: AssetCooker <manifest> <output.pak> [--rgba] [--max-size N]" << std::endl;
+        return 1;
+    }
+
+    bool rgba = false;
+    int maxSize = 2048;
+    for (int i = 3; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--rgba") rgba = true;
+        else if (arg == "--max-size" && i + 1 < argc) maxSize = std::max(1, atoi(argv[++i]));
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::ifstream manifest(argv[1]);
+    if (!manifest) {
+        std::cerr << "Failed to open manifest: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // One "<texture|sprite|sound> <path>" per line; '#' starts a comment
+    std::vector<CookedAsset> assets;
+    std::string line;
+    int lineNumber = 0;
+    bool failed = false;
+    while (std::getline(manifest, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+
+        std::istringstream fields(line);
+        std::string kind, path;
+        if (!(fields >> kind)) continue;
+        if (!(fields >> path) || path.size() >= PACK_NAME_LENGTH) {
+            std::cerr << argv[1] << ":" << lineNumber << ": expected a path shorter than "
+                << PACK_NAME_LENGTH << " characters" << std::endl;
+            failed = true;
+            continue;
+        }
+
+        CookedAsset asset;
+        asset.entry = {};
+        SetName(asset.entry, path);
+
+        bool ok = false;
+        if (kind == "texture") ok = CookTexture(path, rgba, maxSize, asset);
+        else if (kind == "sprite") ok = CookSprite(path, asset);
+        else if (kind == "sound") ok = CookSound(path, asset);
+        else std::cerr << argv[1] << ":" << lineNumber << ": unknown asset kind '" << kind << "'" << std::endl;
+
+        if (!ok) {
+            failed = true;
+            continue;
+        }
+
+        const PackEntry& entry = asset.entry;
+        std::cout << path << ": " << FormatName(entry.format);
+        if (entry.type != PackType::Sound) {
+            std::cout << " " << entry.width << "x" << entry.height << ", " << entry.levels << " level(s)";
+        }
+        std::cout << ", " << asset.blob.size() / 1024 << " KB" << std::endl;
+        assets.push_back(std::move(asset));
+    }
+
+    // A partial pack would silently shadow nothing and load the rest loose; refuse instead
+    if (failed) {
+        std::cerr << "Not writing " << argv[2] << " because some assets failed" << std::endl;
+        return 1;
+    }
+    if (!WritePack(argv[2], assets)) return 1;
+
+    std::cout << "Wrote " << assets.size() << " assets to " << argv[2] << std::endl;
+    return 0;
+}
@@ -0,0 +1,431 @@
+// Microbenchmarks for the loading and per-frame paths, written as JSON so
+// results can be compared across releases:
+//   - sound_load_wav / sound_decode / texture_decode: MB/s of file data read,
+//     for the first pass over each file (cold) and repeated passes (warm).
+//     "Cold" means first read by this process; the OS page cache may still
+//     hold the file from an earlier run. texture_decode is the CPU side only.
+//   - texture_load: the same through LoadTexture's path, decode plus the GL
+//     upload, on the hidden window. Its cold pass follows texture_decode's.
+//   - game_update: Game::Update cost per animal, with every animal popping
+//   - audio_reap: AudioSystem::Pump cost per playing voice, on the null backend
+//   - sprite_draw: SpriteBatch cost per sprite on a hidden window, GPU included,
+//     and the instanced path with every sprite moving or none of them
+//
+// Usage: MooWhoBench [--out results.json] [--quick] [--no-render]
+// Run from the game's working directory so the asset paths resolve.
+
+#include <algorithm>                  // std::sort, std::max
+#include <chrono>                     // steady_clock timings
+#include <cstdint>                    // Checksums
+#include <fstream>                    // --out file
+#include <functional>                 // Benchmarked bodies
+#include <iostream>                   // Results and error reporting
+#include <sstream>                    // JSON staging
+#include <string>                     // Names, paths
+#include <vector>                     // Files, samples
+
+#include <glew.h>                     // Offscreen render pass
+#include <glfw3.h>                    // Hidden window for the GL context
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"               // Same image decoder as AssetLoader
+
+#include "AudioDecoder.h"            // MP3/FLAC sounds
+#include "AudioSystem.h"             // Voice reaping
+#include "Game.h"                    // Per-frame update
+#include "Level.h"                   // Synthetic levels
+#include "MappedFile.h"              // Zero-copy file input
+#include "NullAudioBackend.h"        // Voices without a sound card
+#include "SpriteBatch.h"             // Render pass
+#include "SpriteInstances.h"         // Instanced render pass
+#include "WavFile.h"                 // RIFF chunk walk
+
+namespace {
+
+const char* WAV_FILES[] = { "assets/cat.wav", "assets/bird.wav", "assets/lion.wav",
+    "assets/elephant.wav", "assets/dog.wav", "assets/cow.wav", "assets/music.wav" };
+const char* COMPRESSED_FILES[] = { "assets/bday.mp3" };
+const char* IMAGE_FILES[] = { "assets/backg.jpg", "assets/soundboard.jpg", "assets/cat.png",
+    "assets/bird.png", "assets/lion.png", "assets/elephant.png", "assets/dog.png", "assets/cow.png" };
+
+struct Result {
+    std::string name;
+    std::string variant;              // e.g. cold/warm, or empty
+    long long count = 0;              // Entities, voices or sprites; 0 if not scaled
+    std::string unit;
+    double value = 0.0;
+};
+
+std::vector<Result> results;
+bool quick = false;
+
+void Report(const std::string& name, const std::string& variant, long long count, const std::string& unit,
+    double value) {
+    Result result;
+    result.name = name;
+    result.variant = variant;
+    result.count = count;
+    result.unit = unit;
+    result.value = value;
+    results.push_back(result);
+    std::cerr << name << (variant.empty() ? "" : "/" + variant);
+    if (count) std::cerr << " n=" << count;
+    std::cerr << ": " << value << " " << unit << std::endl;
+}
+
+double Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Median seconds per call. Each sample runs the body enough times to last
+// about 10 ms, so clock resolution doesn't matter.
+double Measure(const std::function<void()>& body) {
+    int iterations = 1;
+    while (true) {
+        const double start = Now();
+        for (int i = 0; i < iterations; ++i) body();
+        if (Now() - start >= 0.01 || iterations >= (1 << 24)) break;
+        iterations *= 2;
+    }
+
+    std::vector<double> samples;
+    const int sampleCount = quick ? 3 : 9;
+    for (int s = 0; s < sampleCount; ++s) {
+        const double start = Now();
+        for (int i = 0; i < iterations; ++i) body();
+        samples.push_back((Now() - start) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// Keeps the compiler from dropping work whose result is unused
+volatile uint64_t sink = 0;
+
+// Returns the number of file bytes processed, or 0 on failure
+size_t LoadWav(const char* path) {
+    MappedFile file;
+    WavInfo wav;
+    if (!file.Open(path) || !ParseWavChunks(file.Data(), file.Size(), wav, path)) return 0;
+
+    // Walk the samples the way an upload would, one read per cache line
+    uint64_t sum = 0;
+    for (size_t i = 0; i < wav.dataSize; i += 64) sum += wav.data[i];
+    sink += sum;
+    return file.Size();
+}
+
+size_t DecodeSound(const char* path) {
+    MappedFile file;
+    DecodedAudio decoded;
+    if (!file.Open(path) || !DecodeAudio(file.Data(), file.Size(), decoded, path)) return 0;
+    sink += decoded.samples.size();
+    return file.Size();
+}
+
+size_t DecodeImage(const char* path) {
+    MappedFile file;
+    if (!file.Open(path)) return 0;
+
+    int width, height, channels;
+    unsigned char* pixels = stbi_load_from_memory(file.Data(), static_cast<int>(file.Size()), &width, &height,
+        &channels, STBI_rgb_alpha);
+    if (!pixels) return 0;
+    sink += pixels[0];
+    stbi_image_free(pixels);
+    return file.Size();
+}
+
+// Decode and upload like LoadTexture(); glFinish so the driver's copy is counted
+size_t LoadTexture(const char* path) {
+    MappedFile file;
+    if (!file.Open(path)) return 0;
+
+    int width, height, channels;
+    unsigned char* pixels = stbi_load_from_memory(file.Data(), static_cast<int>(file.Size()), &width, &height,
+        &channels, STBI_rgb_alpha);
+    if (!pixels) return 0;
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glFinish();
+    stbi_image_free(pixels);
+    glDeleteTextures(1, &texture);
+    return file.Size();
+}
+
+// The first pass over a file set is the cold number; the median of later
+// passes is the warm one
+template <size_t N>
+void BenchLoad(const char* name, const char* (&paths)[N], size_t (*load)(const char*)) {
+    size_t bytes = 0;
+    const double start = Now();
+    for (const char* path : paths) {
+        const size_t loaded = load(path);
+        if (!loaded) {
+            std::cerr << name << ": skipped, " << path << " didn't load" << std::endl;
+            return;
+        }
+        bytes += loaded;
+    }
+    const double cold = Now() - start;
+
+    const double warm = Measure([&]() {
+        for (const char* path : paths) load(path);
+    });
+
+    const double megabytes = bytes / (1024.0 * 1024.0);
+    Report(name, "cold", 0, "MB/s", megabytes / cold);
+    Report(name, "warm", 0, "MB/s", megabytes / warm);
+}
+
+// N animals on a grid, spaced so each click lands on exactly one of them
+LevelDef SyntheticLevel(int count) {
+    LevelDef level;
+    level.buttons.gap = 0.0f;
+    const int columns = 256;
+    for (int i = 0; i < count; ++i) {
+        AnimalDef def;
+        def.id = "animal" + std::to_string(i);
+        def.displayName = def.id;
+        def.x = (i % columns) * 0.25f;
+        def.y = (i / columns) * 0.25f;
+        def.unlocked = true;
+        level.animals.push_back(def);
+    }
+    return level;
+}
+
+void BenchGameUpdate() {
+    NullAudioBackend backend;
+    AudioBackendConfig config;
+    backend.Init(config);
+    AudioSystem audio;
+    audio.Start(&backend, config.voices, false);
+
+    for (int count : { 16, 256, 4096, 65536 }) {
+        if (quick && count > 4096) break;
+
+        const LevelDef level = SyntheticLevel(count);
+        Game game(audio);
+        game.Start(level, std::vector<UVRect>(), std::vector<ALuint>());
+        for (const auto& def : level.animals) {
+            game.HandleClick(def.x + ANIMAL_SIZE / 2, def.y + ANIMAL_SIZE / 2);
+        }
+
+        // A tiny step keeps every animal mid-pop for the whole measurement
+        const double seconds = Measure([&]() { game.Update(1e-9f); });
+        Report("game_update", "popping", count, "ns/entity", seconds * 1e9 / count);
+    }
+
+    audio.Shutdown();
+    backend.Shutdown();
+}
+
+void BenchAudioReap() {
+    for (int voices : { 16, 64, 256 }) {
+        NullAudioBackend backend;
+        AudioBackendConfig config;
+        config.voices = voices;
+        backend.Init(config);
+
+        // Long enough to still be playing when the measurement ends
+        std::vector<int16_t> silence(44100);
+        const ALuint buffer = backend.CreateBuffer(AL_FORMAT_MONO16, silence.data(),
+            silence.size() * sizeof(int16_t), 1, "silence", false);
+
+        AudioSystem audio;
+        audio.Start(&backend, voices, false);
+        for (int v = 0; v < voices; ++v) audio.Play(buffer, VoicePriority::Animal);
+
+        const double seconds = Measure([&]() { audio.Pump(); });
+        Report("audio_reap", "playing", voices, "ns/voice", seconds * 1e9 / voices);
+
+        audio.Shutdown();
+        backend.Shutdown();
+    }
+}
+
+// A hidden 1400x900 window for the GL benchmarks, or nullptr if there's no
+// display or GL. CloseRenderContext() takes it down.
+GLFWwindow* OpenRenderContext() {
+    if (!glfwInit()) {
+        std::cerr << "texture_load, sprite_draw: skipped, GLFW didn't initialize" << std::endl;
+        return nullptr;
+    }
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(1400, 900, "MooWhoBench", NULL, NULL);
+    if (!window) {
+        std::cerr << "texture_load, sprite_draw: skipped, no GL context" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "texture_load, sprite_draw: skipped, GLEW didn't initialize" << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return nullptr;
+    }
+    return window;
+}
+
+void CloseRenderContext(GLFWwindow* window) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+void BenchSpriteDraw() {
+    SpriteBatch batch;
+    if (!batch.Init()) {
+        std::cerr << "sprite_draw: skipped, sprite renderer didn't initialize" << std::endl;
+        return;
+    }
+    glViewport(0, 0, 1400, 900);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // One texture, like the sprite atlas, so only the sprite count varies
+    const unsigned char white[4] = { 255, 255, 255, 255 };
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+
+    for (int count : { 10, 100, 1000, 10000 }) {
+        if (quick && count > 1000) break;
+
+        // glFinish so the GPU's share of the pass is counted too
+        const double seconds = Measure([&]() {
+            glClear(GL_COLOR_BUFFER_BIT);
+            batch.Begin();
+            for (int i = 0; i < count; ++i) {
+                const float x = (i % 100) * 0.02f - 1.0f;
+                const float y = (i / 100 % 100) * 0.02f - 1.0f;
+                batch.Draw(texture, x, y, 0.2f, 0.2f, UVRect(), { 1.0f, 1.0f, 1.0f, 0.5f });
+            }
+            batch.End();
+            glFinish();
+        });
+        Report("sprite_draw", "textured", count, "ns/sprite", seconds * 1e9 / count);
+    }
+
+    InstancedSprites instanced;
+    if (instanced.Init()) {
+        for (int count : { 10, 100, 1000, 10000 }) {
+            if (quick && count > 1000) break;
+
+            std::vector<SpriteInstance> sprites(count);
+            for (int i = 0; i < count; ++i) {
+                const SpriteInstance sprite = { (i % 100) * 0.02f - 1.0f, (i / 100 % 100) * 0.02f - 1.0f, 0.2f, 0.2f,
+                    0.0f, 0.0f, 1.0f, 1.0f };
+                sprites[i] = sprite;
+            }
+
+            // "moving" re-sends every instance each pass; "static" sends none
+            for (bool moving : { true, false }) {
+                InstanceBuffer buffer;
+                buffer.Set(sprites.data(), sprites.size());
+                float offset = 0.0f;
+                const double seconds = Measure([&]() {
+                    if (moving) {
+                        offset = offset == 0.0f ? 0.001f : 0.0f;
+                        for (auto& sprite : sprites) sprite.width = 0.2f + offset;
+                    }
+                    glClear(GL_COLOR_BUFFER_BIT);
+                    buffer.Set(sprites.data(), sprites.size());
+                    instanced.Draw(buffer, texture);
+                    glFinish();
+                });
+                Report("sprite_draw", moving ? "instanced_moving" : "instanced_static", count, "ns/sprite",
+                    seconds * 1e9 / count);
+                buffer.Release();
+            }
+        }
+        instanced.Release();
+    }
+    else {
+        std::cerr << "sprite_draw: instanced variants skipped, GL 3.3 not available" << std::endl;
+    }
+
+    glDeleteTextures(1, &texture);
+    batch.Release();
+}
+
+std::string JsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::string ResultsJson() {
+    std::ostringstream json;
+    json << "{\n  \"suite\": \"MooWhoBench\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        json << "    { \"name\": " << JsonString(r.name) << ", \"variant\": " << JsonString(r.variant)
+             << ", \"count\": " << r.count << ", \"unit\": " << JsonString(r.unit)
+             << ", \"value\": " << r.value << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string outPath;
+    bool render = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+        else if (arg == "--quick") {
+            quick = true;
+        }
+        else if (arg == "--no-render") {
+            render = false;
+        }
+        else {
+            std::cerr << "Usage: MooWhoBench [--out results.json] [--quick] [--no-render]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Progress goes to stderr so stdout holds nothing but the JSON
+    BenchLoad("sound_load_wav", WAV_FILES, LoadWav);
+    BenchLoad("sound_decode", COMPRESSED_FILES, DecodeSound);
+    BenchLoad("texture_decode", IMAGE_FILES, DecodeImage);
+    GLFWwindow* window = render ? OpenRenderContext() : nullptr;
+    if (window) BenchLoad("texture_load", IMAGE_FILES, LoadTexture);
+    BenchGameUpdate();
+    BenchAudioReap();
+    if (window) {
+        BenchSpriteDraw();
+        CloseRenderContext(window);
+    }
+
+    const std::string json = ResultsJson();
+    if (outPath.empty()) {
+        std::cout << json;
+        return 0;
+    }
+    std::ofstream out(outPath, std::ios::out | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to open " << outPath << std::endl;
+        return 1;
+    }
+    out << json;
+    return 0;
+}
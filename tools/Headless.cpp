@@ -0,0 +1,232 @@
+// Runs the game logic with no window, renderer or sound device. Replays an
+// input script (see InputScript.h) on a fixed timestep against the null audio
+// backend, so the same script gives the same result on every machine, and
+// prints what the session ended in:
+//   - found/total animals, and a hash of the whole game state
+//   - ticks simulated and the time spent per tick
+// It also runs the windowed loop's FrameScheduler on the replay clock and
+// fails if a running tween would ever wait longer than the frame cap for its
+// next frame, i.e. if an animation would freeze until some timer fired.
+//
+// Usage: MooWhoHeadless <script> [--level path] [--dt seconds] [--sessions N]
+//                       [--expect-found N] [--expect-hash hex]
+// Every session replays the same script from a fresh Game::Start(), so they
+// must all end in the same state; a mismatch, or a result that differs from
+// the --expect values, exits with 1. Run from the game's working directory so
+// the level's asset paths resolve. Scripts come from `MooWhoGame --record`.
+
+#include <chrono>                     // Per-tick timings
+#include <cstdint>                    // uint64_t state hash
+#include <cstdlib>                    // atoi, atof, strtoull
+#include <iomanip>                    // Hex hash output
+#include <iostream>                   // Results and error reporting
+#include <string>                     // Arguments, paths
+#include <vector>                     // Clicks, per-animal lookups
+
+#include "AudioDecoder.h"            // MP3/FLAC sounds
+#include "AudioSystem.h"             // Voices without a thread
+#include "FrameScheduler.h"          // Frame decisions while animating
+#include "Game.h"                    // The rules being replayed
+#include "InputScript.h"             // Recorded clicks
+#include "Level.h"                   // Animal layout
+#include "MappedFile.h"              // WAV input
+#include "NullAudioBackend.h"        // Keeps time instead of playing
+#include "WavFile.h"                 // RIFF chunk walk
+
+namespace {
+
+const char* DEFAULT_LEVEL = "assets/level1.json";
+const double TAIL_LIMIT = 60.0;       // Seconds simulated past the last click at most
+
+// Only the sound's length matters to the null backend, but it is read the
+// same way the game reads it so a broken file fails here too
+ALuint LoadSound(NullAudioBackend& backend, const std::string& path) {
+    MappedFile file;
+    if (!file.Open(path.c_str())) {
+        std::cerr << "Failed to open sound: " << path << std::endl;
+        return 0;
+    }
+
+    if (IsCompressedAudio(path)) {
+        DecodedAudio decoded;
+        if (!DecodeAudio(file.Data(), file.Size(), decoded, path.c_str())) return 0;
+        return backend.CreateBuffer(PcmFormat(decoded.channels, 16), decoded.samples.data(),
+            decoded.samples.size() * sizeof(int16_t), decoded.sampleRate, path.c_str(), false);
+    }
+
+    WavInfo wav;
+    if (!ParseWavChunks(file.Data(), file.Size(), wav, path.c_str())) return 0;
+    return backend.CreateBuffer(PcmFormat(wav.channels, wav.bitsPerSample), wav.data, wav.dataSize,
+        wav.sampleRate, path.c_str(), false);
+}
+
+struct SessionResult {
+    long long ticks = 0;
+    int found = 0;
+    uint64_t hash = 0;
+    long long stalls = 0;             // Animating ticks whose next frame would come late
+};
+
+SessionResult RunSession(Game& game, AudioSystem& audio, NullAudioBackend& backend, const LevelDef& level,
+    const std::vector<UVRect>& sprites, const std::vector<ALuint>& sounds,
+    const std::vector<ScriptedClick>& clicks, double dt) {
+    audio.StopAll();
+    game.Start(level, sprites, sounds);
+
+    // Same order as the game's main loop: timers, then the input that arrived
+    // during the frame. Once the script runs out, keep going until every
+    // timer has fired and every sound has ended.
+    const double lastClick = clicks.empty() ? 0.0 : clicks.back().time;
+    SessionResult result;
+    FrameScheduler scheduler;
+    const double slot = scheduler.FrameInterval() + 1e-9;  // Allows for rounding in lastFrameTime + interval
+    double time = 0.0;
+    size_t next = 0;
+    while (true) {
+        time += dt;
+        ++result.ticks;
+        backend.Advance(dt);
+        audio.Pump();
+        AudioEvent event;
+        while (audio.PollEvent(event)) {
+            if (event.type == AudioEvent::Type::Finished) game.SoundFinished(event.play);
+        }
+        game.Update(static_cast<float>(dt));
+
+        while (next < clicks.size() && clicks[next].time <= time) {
+            game.HandleClick(clicks[next].x, clicks[next].y);
+            ++next;
+        }
+
+        // What the windowed loop does after its update: render if asked to,
+        // then sleep until the next frame slot or timer
+        scheduler.SetAnimating(game.Animating());
+        if (scheduler.ShouldRender()) scheduler.FrameRenderedAt(time);
+        if (game.Animating() && scheduler.SleepTime(time) > slot) ++result.stalls;
+
+        if (next < clicks.size()) continue;
+        const bool settled = game.NextTimer() < 0.0f && !game.Animating()
+            && audio.LiveVoices() == 0;
+        if (settled || time - lastClick > TAIL_LIMIT) break;
+    }
+
+    result.found = game.FoundCount();
+    result.hash = game.StateHash();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: MooWhoHeadless <script> [--level path] [--dt seconds] [--sessions N]"
+                     " [--expect-found N] [--expect-hash hex]" << std::endl;
+        return 1;
+    }
+
+    const char* scriptPath = argv[1];
+    std::string levelPath = DEFAULT_LEVEL;
+    double dt = SIM_STEP;             // The windowed game's step
+    int sessions = 1;
+    int expectFound = -1;
+    bool checkHash = false;
+    uint64_t expectHash = 0;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--level" && i + 1 < argc) {
+            levelPath = argv[++i];
+        }
+        else if (arg == "--dt" && i + 1 < argc) {
+            dt = std::atof(argv[++i]);
+        }
+        else if (arg == "--sessions" && i + 1 < argc) {
+            sessions = std::atoi(argv[++i]);
+        }
+        else if (arg == "--expect-found" && i + 1 < argc) {
+            expectFound = std::atoi(argv[++i]);
+        }
+        else if (arg == "--expect-hash" && i + 1 < argc) {
+            expectHash = std::strtoull(argv[++i], nullptr, 16);
+            checkHash = true;
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (dt <= 0.0 || sessions < 1) {
+        std::cerr << "--dt and --sessions must be positive" << std::endl;
+        return 1;
+    }
+
+    std::vector<ScriptedClick> clicks;
+    if (!LoadInputScript(scriptPath, clicks)) return 1;
+
+    LevelDef level;
+    if (!LoadLevel(levelPath.c_str(), level)) return 1;
+
+    NullAudioBackend backend;
+    AudioBackendConfig config;
+    backend.Init(config);
+
+    // Sprites are never drawn, so every animal gets the default rectangle
+    std::vector<UVRect> sprites(level.animals.size());
+    std::vector<ALuint> sounds;
+    for (const auto& def : level.animals) {
+        sounds.push_back(LoadSound(backend, def.sound));
+    }
+    const ALuint correctSound = LoadSound(backend, "assets/correct.wav");
+    const ALuint incorrectSound = LoadSound(backend, "assets/incorrect.wav");
+
+    AudioSystem audio;
+    if (!audio.Start(&backend, config.voices, false)) {
+        std::cerr << "Failed to create audio voices" << std::endl;
+        return 1;
+    }
+
+    Game game(audio);
+    game.SetFeedbackSounds(correctSound, incorrectSound);
+
+    SessionResult first;
+    long long totalTicks = 0;
+    bool consistent = true;
+    const auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < sessions; ++s) {
+        const SessionResult result = RunSession(game, audio, backend, level, sprites, sounds, clicks, dt);
+        totalTicks += result.ticks;
+        if (s == 0) {
+            first = result;
+        }
+        else if (result.hash != first.hash || result.ticks != first.ticks) {
+            std::cerr << "Session " << s << " diverged from session 0" << std::endl;
+            consistent = false;
+            break;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    audio.Shutdown();
+    backend.Shutdown();
+
+    std::cout << "sessions=" << sessions << "\n"
+              << "ticks=" << first.ticks << "\n"
+              << "ns_per_tick=" << (totalTicks > 0 ? seconds * 1e9 / totalTicks : 0.0) << "\n"
+              << "found=" << first.found << "/" << level.animals.size() << "\n"
+              << "hash=" << std::hex << std::setw(16) << std::setfill('0') << first.hash << std::dec << std::endl;
+
+    if (!consistent) return 1;
+    if (first.stalls > 0) {
+        std::cerr << first.stalls << " animating ticks would wait past the frame cap for their next frame"
+                  << std::endl;
+        return 1;
+    }
+    if (expectFound >= 0 && first.found != expectFound) {
+        std::cerr << "Expected " << expectFound << " animals found, got " << first.found << std::endl;
+        return 1;
+    }
+    if (checkHash && first.hash != expectHash) {
+        std::cerr << "State hash doesn't match --expect-hash" << std::endl;
+        return 1;
+    }
+    return 0;
+}